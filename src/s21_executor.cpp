@@ -0,0 +1,174 @@
+#include "s21_executor.h"
+
+#include <chrono>
+
+using namespace std;
+
+thread_local S21Executor* S21Executor::current_ = nullptr;
+thread_local int S21Executor::current_index_ = -1;
+
+S21Executor::S21Executor(int threads)
+    : pending_(0), next_queue_(0), stop_(false) {
+  if (threads <= 0) threads = 1;
+  for (int i = 0; i < threads; i++) queues_.push_back(make_unique<Queue>());
+  for (int i = 0; i < threads; i++)
+    workers_.emplace_back(&S21Executor::workerLoop, this, i);
+}
+
+S21Executor::~S21Executor() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  ready_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+S21Executor& S21Executor::Instance() {
+  static S21Executor executor(thread::hardware_concurrency());
+  return executor;
+}
+
+int S21Executor::threads() const noexcept { return workers_.size(); }
+
+void S21Executor::Submit(function<void()> task) {
+  bool own = current_ == this;
+  int index = own ? current_index_ : next_queue_++ % queues_.size();
+  {
+    lock_guard<mutex> lock(mutex_);
+    pending_++;
+  }
+  {
+    lock_guard<mutex> lock(queues_[index]->mutex_);
+    queues_[index]->tasks_.push_back(std::move(task));
+  }
+  ready_.notify_one();
+}
+
+bool S21Executor::take(function<void()>& task) {
+  int count = queues_.size();
+  if (current_ == this) {  // own deque from the back
+    Queue& own = *queues_[current_index_];
+    lock_guard<mutex> lock(own.mutex_);
+    if (!own.tasks_.empty()) {
+      task = std::move(own.tasks_.back());
+      own.tasks_.pop_back();
+      pending_--;
+      return true;
+    }
+  }
+  int start = current_ == this ? current_index_ + 1 : 0;
+  for (int i = 0; i < count; i++) {  // steal the oldest task elsewhere
+    Queue& victim = *queues_[(start + i) % count];
+    lock_guard<mutex> lock(victim.mutex_);
+    if (victim.tasks_.empty()) continue;
+    task = std::move(victim.tasks_.front());
+    victim.tasks_.pop_front();
+    pending_--;
+    return true;
+  }
+  return false;
+}
+
+bool S21Executor::RunOne() {
+  function<void()> task;
+  if (!take(task)) return false;
+  task();
+  return true;
+}
+
+void S21Executor::workerLoop(int index) {
+  current_ = this;
+  current_index_ = index;
+  for (;;) {
+    if (RunOne()) continue;
+    unique_lock<mutex> lock(mutex_);
+    ready_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) return;  // stopping and drained
+  }
+}
+
+void S21Executor::ParallelFor(int count, int chunk,
+                              const function<void(int, int)>& fn) {
+  if (chunk <= 0) chunk = 1;
+  int chunks = (count + chunk - 1) / chunk;
+  if (chunks <= 1 || threads() <= 1) {
+    if (count > 0) fn(0, count);
+    return;
+  }
+  struct Progress {
+    atomic<int> next{0};
+    atomic<bool> failed{false};
+    int done = 0;
+    exception_ptr error;  // first exception thrown by fn
+    mutex mutex_;
+    condition_variable all_done;
+  };
+  auto progress = make_shared<Progress>();
+  const function<void(int, int)>* body = &fn;
+  auto work = [progress, body, chunks, chunk, count]() {
+    for (int c = progress->next++; c < chunks; c = progress->next++) {
+      exception_ptr error;
+      if (!progress->failed) {  // after a failure the rest is only counted
+        try {
+          (*body)(c * chunk, min(count, (c + 1) * chunk));
+        } catch (...) {
+          error = current_exception();
+        }
+      }
+      lock_guard<mutex> lock(progress->mutex_);
+      if (error && !progress->error) {
+        progress->error = error;
+        progress->failed = true;
+      }
+      if (++progress->done == chunks) progress->all_done.notify_all();
+    }
+  };
+  int helpers = min(threads(), chunks - 1);
+  for (int i = 0; i < helpers; i++) Submit(work);
+  work();
+  unique_lock<mutex> lock(progress->mutex_);
+  progress->all_done.wait(lock, [&] { return progress->done == chunks; });
+  // every chunk has returned, so nothing touches fn once this rethrows
+  if (progress->error) rethrow_exception(progress->error);
+}
+
+int S21TaskGraph::Add(function<void()> fn) {
+  nodes_.emplace_back();
+  nodes_.back().fn = std::move(fn);
+  return nodes_.size() - 1;
+}
+
+void S21TaskGraph::Depend(int task, int on) {
+  nodes_[on].next.push_back(task);
+  nodes_[task].dependencies++;
+}
+
+void S21TaskGraph::submit(int id) {
+  S21Executor::Instance().Submit([this, id] {
+    Node& node = nodes_[id];
+    node.fn();
+    for (int next : node.next)
+      if (--nodes_[next].waiting == 0) submit(next);
+    lock_guard<mutex> lock(mutex_);
+    if (--remaining_ == 0) done_.notify_all();
+  });
+}
+
+void S21TaskGraph::Run() {
+  remaining_ = nodes_.size();
+  for (Node& node : nodes_) node.waiting = node.dependencies;
+  for (size_t id = 0; id < nodes_.size(); id++)
+    if (nodes_[id].dependencies == 0) submit(id);
+  S21Executor& executor = S21Executor::Instance();
+  for (;;) {
+    {
+      unique_lock<mutex> lock(mutex_);
+      if (remaining_ == 0) return;
+    }
+    if (executor.RunOne()) continue;
+    unique_lock<mutex> lock(mutex_);
+    done_.wait_for(lock, chrono::microseconds(100),
+                   [this] { return remaining_ == 0; });
+  }
+}
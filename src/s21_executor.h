@@ -0,0 +1,195 @@
+#ifndef SRC_S21_EXECUTOR_H_
+#define SRC_S21_EXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Library-owned work-stealing thread pool on which the *Async operations
+// are scheduled. Every worker owns a deque: tasks submitted from a worker go
+// to the back of its own deque and are popped from there (newest first),
+// tasks from other threads are spread over the deques, and an idle worker
+// steals the oldest task of another one.
+class S21Executor {
+ private:
+  struct Queue {
+    mutex mutex_;
+    deque<function<void()>> tasks_;
+  };
+  vector<unique_ptr<Queue>> queues_;
+  mutex mutex_;  // guards stop_ and sleeping on ready_
+  condition_variable ready_;
+  atomic<int> pending_;  // submitted and not yet taken
+  atomic<unsigned> next_queue_;
+  vector<thread> workers_;
+  bool stop_;
+  static thread_local S21Executor* current_;  // pool of the calling worker
+  static thread_local int current_index_;
+  void workerLoop(int index);
+  bool take(function<void()>& task);
+
+ public:
+  explicit S21Executor(int threads);
+  S21Executor(const S21Executor&) = delete;
+  S21Executor& operator=(const S21Executor&) = delete;
+  ~S21Executor();
+
+  static S21Executor& Instance();
+  int threads() const noexcept;
+  void Submit(function<void()> task);
+  // Runs one queued task on the calling thread, if there is any; lets a
+  // thread that waits for pool work help instead of blocking a worker
+  bool RunOne();
+  // Runs fn(begin, end) over [0, count) in chunks on the pool. The caller
+  // takes chunks too and only waits for ones already running, so it is safe
+  // to call from inside a pool task. If fn throws, chunks not yet started
+  // are skipped and the first exception is rethrown on the caller once every
+  // running chunk has returned.
+  void ParallelFor(int count, int chunk, const function<void(int, int)>& fn);
+};
+
+// Static DAG of tasks on the executor: a task is submitted as soon as all
+// the tasks it depends on have finished, so independent branches overlap
+// without any fork-join barrier. Run() executes pool tasks while it waits
+// and may therefore be called from inside a pool task; tasks must not throw.
+class S21TaskGraph {
+ private:
+  struct Node {
+    function<void()> fn;
+    vector<int> next;
+    int dependencies = 0;
+    atomic<int> waiting{0};
+  };
+  deque<Node> nodes_;
+  mutex mutex_;
+  condition_variable done_;
+  int remaining_ = 0;  // guarded by mutex_
+  void submit(int id);
+
+ public:
+  int Add(function<void()> fn);  // returns the task id
+  void Depend(int task, int on);  // task runs after on
+  void Run();
+};
+
+// Shared handle to a value produced on the executor. Continuations attached
+// through Then/S21Async run as soon as every dependency is done, so a DAG of
+// operations never blocks a worker or round-trips through the caller.
+template <typename T>
+class S21Future {
+ private:
+  struct State {
+    mutex mutex_;
+    condition_variable done_cv_;
+    bool done_ = false;
+    T value_{};
+    exception_ptr error_;
+    vector<function<void()>> continuations_;
+  };
+  shared_ptr<State> state_;
+
+  void complete(T value, exception_ptr error) const {
+    vector<function<void()>> continuations;
+    {
+      lock_guard<mutex> lock(state_->mutex_);
+      state_->value_ = std::move(value);
+      state_->error_ = error;
+      state_->done_ = true;
+      continuations.swap(state_->continuations_);
+    }
+    state_->done_cv_.notify_all();
+    for (auto& next : continuations) next();
+  }
+
+  void whenDone(function<void()> next) const {
+    {
+      lock_guard<mutex> lock(state_->mutex_);
+      if (!state_->done_) {
+        state_->continuations_.push_back(std::move(next));
+        return;
+      }
+    }
+    next();
+  }
+
+  exception_ptr error() const { return state_->error_; }
+
+  template <typename U>
+  friend class S21Future;
+  template <typename F, typename... Deps>
+  friend auto S21Async(F fn, const S21Future<Deps>&... deps)
+      -> S21Future<decay_t<invoke_result_t<F, const Deps&...>>>;
+
+ public:
+  S21Future() = default;
+
+  static S21Future Ready(T value) {
+    S21Future result;
+    result.state_ = make_shared<State>();
+    result.complete(std::move(value), nullptr);
+    return result;
+  }
+
+  bool valid() const noexcept { return state_ != nullptr; }
+
+  bool ready() const {
+    lock_guard<mutex> lock(state_->mutex_);
+    return state_->done_;
+  }
+
+  void wait() const {
+    unique_lock<mutex> lock(state_->mutex_);
+    state_->done_cv_.wait(lock, [this] { return state_->done_; });
+  }
+
+  const T& get() const {  // rethrows whatever the task threw
+    wait();
+    if (state_->error_) rethrow_exception(state_->error_);
+    return state_->value_;
+  }
+
+  template <typename F>
+  auto Then(F fn) const {
+    return S21Async(std::move(fn), *this);
+  }
+};
+
+// Schedules fn(deps.get()...) once all deps are done; a failed dependency
+// fails the result with the same exception without calling fn
+template <typename F, typename... Deps>
+auto S21Async(F fn, const S21Future<Deps>&... deps)
+    -> S21Future<decay_t<invoke_result_t<F, const Deps&...>>> {
+  using R = decay_t<invoke_result_t<F, const Deps&...>>;
+  S21Future<R> result;
+  result.state_ = make_shared<typename S21Future<R>::State>();
+  auto pending = make_shared<atomic<int>>(sizeof...(Deps) + 1);
+  auto run = [result, fn, deps...]() {
+    exception_ptr error;
+    for (exception_ptr e : {exception_ptr(), deps.error()...})
+      if (e && !error) error = e;
+    if (error) return result.complete(R{}, error);
+    try {
+      R value = fn(deps.get()...);
+      result.complete(std::move(value), nullptr);
+    } catch (...) {
+      result.complete(R{}, current_exception());
+    }
+  };
+  auto release = [pending, run]() {
+    if (pending->fetch_sub(1) == 1) S21Executor::Instance().Submit(run);
+  };
+  (deps.whenDone(release), ...);
+  release();
+  return result;
+}
+
+#endif  // SRC_S21_EXECUTOR_H_
@@ -0,0 +1,118 @@
+#ifndef SRC_S21_KERNELS_H_
+#define SRC_S21_KERNELS_H_
+
+// Dense kernels on contiguous row-major buffers shared by the library's
+// translation units; not part of the public interface.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+template <typename T>
+inline bool luFactor(T* a, int n, int* piv) noexcept {  // in place, row-major
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++)
+      if (fabs(a[i * n + k]) > fabs(a[p * n + k])) p = i;
+    piv[k] = p;
+    if (a[p * n + k] == T(0)) return false;
+    if (p != k)
+      for (int j = 0; j < n; j++) swap(a[k * n + j], a[p * n + j]);
+    T inv = T(1) / a[k * n + k];
+    for (int i = k + 1; i < n; i++) {
+      T l = a[i * n + k] *= inv;
+      if (l == T(0)) continue;
+      for (int j = k + 1; j < n; j++) a[i * n + j] -= l * a[k * n + j];
+    }
+  }
+  return true;
+}
+
+// Same contract as luFactor for large n: panel factorizations and
+// column-block updates run as a task graph on S21Executor, so the next
+// panel starts while the rest of the trailing matrix is still updated.
+// Instantiated for double and float.
+template <typename T>
+bool luFactorTiled(T* a, int n, int* piv);
+
+// luSolve for many right-hand sides: b is split into column blocks that
+// are solved in parallel on S21Executor. Instantiated for double and float.
+template <typename T>
+void luSolveColumns(const T* lu, const int* piv, int n, T* b, int nrhs);
+
+// c += alpha * a * b on row-major float buffers, a m x depth and b depth x n
+// with row strides lda, ldb, ldc; blocked and threaded like Gemm
+void gemmFloat(int m, int n, int depth, float alpha, const float* a, int lda,
+               const float* b, int ldb, float* c, int ldc);
+// c += a * b for contiguous float a (m x depth) and b (depth x n) into the
+// double rows of c; every product is widened to double and summed there
+void gemmMixed(int m, int n, int depth, const float* a, const float* b,
+               double** c);
+
+template <typename T>
+inline void luSolve(const T* lu, const int* piv, int n, T* b,
+                    int nrhs) noexcept {  // b is n x nrhs, row-major
+  for (int k = 0; k < n; k++)
+    if (piv[k] != k)
+      for (int j = 0; j < nrhs; j++)
+        swap(b[k * nrhs + j], b[piv[k] * nrhs + j]);
+  for (int i = 1; i < n; i++) {
+    for (int k = 0; k < i; k++) {
+      T l = lu[i * n + k];
+      if (l == T(0)) continue;
+      for (int j = 0; j < nrhs; j++) b[i * nrhs + j] -= l * b[k * nrhs + j];
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    for (int k = i + 1; k < n; k++) {
+      T u = lu[i * n + k];
+      if (u == T(0)) continue;
+      for (int j = 0; j < nrhs; j++) b[i * nrhs + j] -= u * b[k * nrhs + j];
+    }
+    T inv = T(1) / lu[i * n + i];
+    for (int j = 0; j < nrhs; j++) b[i * nrhs + j] *= inv;
+  }
+}
+
+template <typename T>
+inline T luDeterminant(const T* lu, const int* piv, int n) noexcept {
+  T det = T(1);
+  for (int k = 0; k < n; k++)
+    det *= piv[k] != k ? -lu[k * n + k] : lu[k * n + k];
+  return det;
+}
+
+// Whether n pivots spaced stride apart are numerically singular: the
+// smallest is at most n * epsilon times scale, the largest pivot unless
+// given. Unlike a threshold on the determinant this does not depend on the
+// scale of A, and it does not break when the product of the pivots over- or
+// underflows.
+template <typename T>
+inline bool pivotsSingular(const T* pivots, int n, size_t stride,
+                           T scale = T(0)) noexcept {
+  T smallest = numeric_limits<T>::infinity(), largest = T(0);
+  for (int k = 0; k < n; k++) {
+    T pivot = fabs(pivots[k * stride]);
+    smallest = min(smallest, pivot);
+    largest = max(largest, pivot);
+  }
+  if (scale == T(0)) scale = largest;
+  return !(smallest > n * numeric_limits<T>::epsilon() * scale);
+}
+
+// pivotsSingular on the diagonal of an n x n row-major factorization
+template <typename T>
+inline bool luSingular(const T* lu, int n, T scale = T(0)) noexcept {
+  return pivotsSingular(lu, n, static_cast<size_t>(n) + 1, scale);
+}
+
+template <typename T>
+inline void packRows(double** m, int rows, int cols, T* out) noexcept {
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) out[i * cols + j] = static_cast<T>(m[i][j]);
+}
+
+#endif  // SRC_S21_KERNELS_H_
@@ -0,0 +1,77 @@
+#include "s21_matrix_oop.h"
+
+using namespace std;
+
+S21Future<S21Matrix> SumMatrixAsync(const S21Future<S21Matrix>& a,
+                                    const S21Future<S21Matrix>& b) {
+  return S21Async(
+      [](const S21Matrix& x, const S21Matrix& y) { return x + y; }, a, b);
+}
+
+S21Future<S21Matrix> SubMatrixAsync(const S21Future<S21Matrix>& a,
+                                    const S21Future<S21Matrix>& b) {
+  return S21Async(
+      [](const S21Matrix& x, const S21Matrix& y) { return x - y; }, a, b);
+}
+
+S21Future<S21Matrix> MulNumberAsync(const S21Future<S21Matrix>& a,
+                                    double num) {
+  return a.Then([num](const S21Matrix& x) { return x * num; });
+}
+
+S21Future<S21Matrix> MulMatrixAsync(const S21Future<S21Matrix>& a,
+                                    const S21Future<S21Matrix>& b) {
+  return S21Async(
+      [](const S21Matrix& x, const S21Matrix& y) { return x * y; }, a, b);
+}
+
+S21Future<S21Matrix> TransposeAsync(const S21Future<S21Matrix>& a) {
+  return a.Then([](const S21Matrix& x) { return x.Transpose(); });
+}
+
+S21Future<S21Matrix> CalcComplementsAsync(const S21Future<S21Matrix>& a) {
+  return a.Then([](const S21Matrix& x) { return x.CalcComplements(); });
+}
+
+S21Future<double> DeterminantAsync(const S21Future<S21Matrix>& a) {
+  return a.Then([](const S21Matrix& x) { return x.Determinant(); });
+}
+
+S21Future<S21Matrix> InverseMatrixAsync(const S21Future<S21Matrix>& a) {
+  return a.Then([](const S21Matrix& x) { return x.InverseMatrix(); });
+}
+
+S21Future<S21Matrix> S21Matrix::SumMatrixAsync(const S21Matrix& other) const {
+  return ::SumMatrixAsync(S21Future<S21Matrix>::Ready(*this),
+                          S21Future<S21Matrix>::Ready(other));
+}
+
+S21Future<S21Matrix> S21Matrix::SubMatrixAsync(const S21Matrix& other) const {
+  return ::SubMatrixAsync(S21Future<S21Matrix>::Ready(*this),
+                          S21Future<S21Matrix>::Ready(other));
+}
+
+S21Future<S21Matrix> S21Matrix::MulNumberAsync(const double num) const {
+  return ::MulNumberAsync(S21Future<S21Matrix>::Ready(*this), num);
+}
+
+S21Future<S21Matrix> S21Matrix::MulMatrixAsync(const S21Matrix& other) const {
+  return ::MulMatrixAsync(S21Future<S21Matrix>::Ready(*this),
+                          S21Future<S21Matrix>::Ready(other));
+}
+
+S21Future<S21Matrix> S21Matrix::TransposeAsync() const {
+  return ::TransposeAsync(S21Future<S21Matrix>::Ready(*this));
+}
+
+S21Future<S21Matrix> S21Matrix::CalcComplementsAsync() const {
+  return ::CalcComplementsAsync(S21Future<S21Matrix>::Ready(*this));
+}
+
+S21Future<double> S21Matrix::DeterminantAsync() const {
+  return ::DeterminantAsync(S21Future<S21Matrix>::Ready(*this));
+}
+
+S21Future<S21Matrix> S21Matrix::InverseMatrixAsync() const {
+  return ::InverseMatrixAsync(S21Future<S21Matrix>::Ready(*this));
+}
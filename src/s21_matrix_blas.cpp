@@ -0,0 +1,343 @@
+#include <climits>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+#include "s21_tuning.h"
+
+using namespace std;
+
+template <typename T>
+struct GemmArgs {
+  T alpha;
+  T** a;
+  T** b;
+  T** c;
+  bool trans_a;
+  bool trans_b;
+  int n;
+  int depth;
+  int a_lower, a_upper, b_lower, b_upper;  // loops skip outside the bands
+  int block_k;
+  int block_n;
+};
+
+template <typename T>
+static void gemmRows(const GemmArgs<T>& g, int row_begin, int row_end) {
+  T **a = g.a, **b = g.b;
+  if (!g.trans_b) {  // i-k-j over k/j blocks: rows of B and C stay in cache
+    for (int k0 = 0; k0 < g.depth; k0 += g.block_k) {
+      int k1 = min(g.depth, k0 + g.block_k);
+      for (int j0 = 0; j0 < g.n; j0 += g.block_n) {
+        int j1 = min(g.n, j0 + g.block_n);
+        for (int i = row_begin; i < row_end; i++) {
+          T* ci = g.c[i];
+          int k_end = min(k1, i + g.a_upper + 1);
+          for (int k = max(k0, i - g.a_lower); k < k_end; k++) {
+            T aik = g.alpha * (g.trans_a ? a[k][i] : a[i][k]);
+            const T* bk = b[k];
+            int j = max(j0, k - g.b_lower), j_end = min(j1, k + g.b_upper + 1);
+            // all loads before the stores, so the four lanes vectorize
+            // without the alias checks -O2 refuses to emit
+            for (; j + 3 < j_end; j += 4) {
+              T x[4], y[4];
+              for (int l = 0; l < 4; l++) x[l] = bk[j + l], y[l] = ci[j + l];
+              for (int l = 0; l < 4; l++) ci[j + l] = y[l] + aik * x[l];
+            }
+            for (; j < j_end; j++) ci[j] += aik * bk[j];
+          }
+        }
+      }
+    }
+  } else {  // rows of op(B) are rows of B: contiguous dot products
+    for (int i = row_begin; i < row_end; i++) {
+      T* ci = g.c[i];
+      for (int j = 0; j < g.n; j++) {
+        const T* bj = b[j];
+        T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        int k = 0;
+        if (!g.trans_a) {
+          const T* ai = a[i];
+          for (; k + 3 < g.depth; k += 4) {
+            s0 += ai[k] * bj[k];
+            s1 += ai[k + 1] * bj[k + 1];
+            s2 += ai[k + 2] * bj[k + 2];
+            s3 += ai[k + 3] * bj[k + 3];
+          }
+        }
+        for (; k < g.depth; k++) s0 += (g.trans_a ? a[k][i] : a[i][k]) * bj[k];
+        ci[j] += g.alpha * ((s0 + s1) + (s2 + s3));
+      }
+    }
+  }
+}
+
+template <typename T>
+static void gemmDispatch(const GemmArgs<T>& g, int rows,
+                         const S21Tuning& tuning) {
+  double work = static_cast<double>(rows) * g.n * g.depth;
+  if (work < tuning.parallel_threshold) return gemmRows(g, 0, rows);
+  S21Executor::Instance().ParallelFor(
+      rows, tuning.row_chunk,
+      [&g](int begin, int end) { gemmRows(g, begin, end); });
+}
+
+void S21Matrix::gemmKernel(double alpha, const S21Matrix& a, bool trans_a,
+                           const S21Matrix& b, bool trans_b, S21Matrix& c) {
+  S21Tuning tuning = S21Autotuner::Current();
+  GemmArgs<double> g = {};
+  g.alpha = alpha;
+  g.a = a.matrix_, g.b = b.matrix_, g.c = c.matrix_;
+  g.trans_a = trans_a, g.trans_b = trans_b;
+  g.n = c.cols_;
+  g.depth = trans_a ? a.rows_ : a.cols_;
+  g.block_k = tuning.block_k;
+  g.block_n = tuning.block_n;
+  if (!trans_b) {
+    a.Bandwidth(&g.a_lower, &g.a_upper);
+    b.Bandwidth(&g.b_lower, &g.b_upper);
+    if (trans_a) swap(g.a_lower, g.a_upper);
+  }
+  gemmDispatch(g, c.rows_, tuning);
+}
+
+// Row pointers of a row-major float buffer for GemmArgs
+static vector<float*> floatRows(const float* data, int rows, int ld) {
+  vector<float*> result(rows);
+  for (int i = 0; i < rows; i++)
+    result[i] = const_cast<float*>(data) + static_cast<size_t>(i) * ld;
+  return result;
+}
+
+static GemmArgs<float> floatArgs(float alpha, int n, int depth,
+                                 const S21Tuning& tuning) {
+  GemmArgs<float> g = {};
+  g.alpha = alpha;
+  g.n = n;
+  g.depth = depth;
+  g.a_lower = g.a_upper = g.b_lower = g.b_upper = INT_MAX / 2;  // dense
+  g.block_k = tuning.block_k;
+  g.block_n = tuning.block_n;
+  return g;
+}
+
+void gemmFloat(int m, int n, int depth, float alpha, const float* a, int lda,
+               const float* b, int ldb, float* c, int ldc) {
+  if (m <= 0 || n <= 0 || depth <= 0) return;
+  S21Tuning tuning = S21Autotuner::Current();
+  vector<float*> ra = floatRows(a, m, lda), rb = floatRows(b, depth, ldb),
+                 rc = floatRows(c, m, ldc);
+  GemmArgs<float> g = floatArgs(alpha, n, depth, tuning);
+  g.a = ra.data(), g.b = rb.data(), g.c = rc.data();
+  gemmDispatch(g, m, tuning);
+}
+
+// c += a * b over rows [row_begin, row_end) in the k/j blocking of
+// gemmRows. Each float product is formed in double, where it is exact, so
+// only the double sums round.
+static void mixedRows(const float* a, const float* b, double** c, int n,
+                      int depth, const S21Tuning& tuning, int row_begin,
+                      int row_end) {
+  for (int k0 = 0; k0 < depth; k0 += tuning.block_k) {
+    int k1 = min(depth, k0 + tuning.block_k);
+    for (int j0 = 0; j0 < n; j0 += tuning.block_n) {
+      int j1 = min(n, j0 + tuning.block_n);
+      for (int i = row_begin; i < row_end; i++) {
+        double* ci = c[i];
+        const float* ai = a + static_cast<size_t>(i) * depth;
+        for (int k = k0; k < k1; k++) {
+          double aik = ai[k];
+          const float* bk = b + static_cast<size_t>(k) * n;
+          int j = j0;
+          for (; j + 3 < j1; j += 4) {  // loads first, as in gemmRows
+            double x[4], y[4];
+            for (int l = 0; l < 4; l++) x[l] = bk[j + l], y[l] = ci[j + l];
+            for (int l = 0; l < 4; l++) ci[j + l] = y[l] + aik * x[l];
+          }
+          for (; j < j1; j++) ci[j] += aik * static_cast<double>(bk[j]);
+        }
+      }
+    }
+  }
+}
+
+void gemmMixed(int m, int n, int depth, const float* a, const float* b,
+               double** c) {
+  if (m <= 0 || n <= 0 || depth <= 0) return;
+  S21Tuning tuning = S21Autotuner::Current();
+  double work = static_cast<double>(m) * n * depth;
+  if (work < tuning.parallel_threshold)
+    return mixedRows(a, b, c, n, depth, tuning, 0, m);
+  S21Executor::Instance().ParallelFor(
+      m, tuning.row_chunk, [&](int begin, int end) {
+        mixedRows(a, b, c, n, depth, tuning, begin, end);
+      });
+}
+
+void S21Matrix::mulInto(const S21Matrix& a, const S21Matrix& b,
+                        S21Matrix& result) {
+  gemmKernel(1.0, a, false, b, false, result);
+}
+
+void Gemm(double alpha, const S21Matrix& a, const S21Matrix& b, double beta,
+          S21Matrix& c, bool trans_a, bool trans_b) {
+  int m = trans_a ? a.cols_ : a.rows_, depth = trans_a ? a.rows_ : a.cols_;
+  int n = trans_b ? b.rows_ : b.cols_;
+  if ((trans_b ? b.cols_ : b.rows_) != depth) throw ERROR_CALC;
+  if (c.rows_ != m || c.cols_ != n || c.matrix_ == nullptr) throw ERROR_CALC;
+  if (&c == &a || &c == &b) {  // the kernel reads A and B while writing C
+    S21Matrix result(c);
+    Gemm(alpha, a, b, beta, result, trans_a, trans_b);
+    c = std::move(result);
+    return;
+  }
+  c.detach();
+  for (int i = 0; i < m; i++) {
+    double* ci = c.matrix_[i];
+    if (beta == 0.0)
+      fill(ci, ci + n, 0.0);
+    else if (beta != 1.0)
+      for (int j = 0; j < n; j++) ci[j] *= beta;
+  }
+  if (alpha != 0.0 && depth > 0)
+    S21Matrix::gemmKernel(alpha, a, trans_a, b, trans_b, c);
+}
+
+void Axpy(double alpha, const S21Matrix& x, S21Matrix& y) {
+  if (x.rows_ != y.rows_ || x.cols_ != y.cols_) throw ERROR_CALC;
+  y.detach();
+  for (int i = 0; i < y.rows_; i++) {
+    const double* xi = x.matrix_[i];
+    double* yi = y.matrix_[i];
+    for (int j = 0; j < y.cols_; j++) yi[j] += alpha * xi[j];
+  }
+}
+
+S21Matrix S21Matrix::Pow(int n) const {
+  if (rows_ != cols_ || rows_ == 0) throw ERROR_CALC;
+  unsigned long exponent = n < 0 ? -static_cast<long>(n) : n;
+  S21Matrix base = n < 0 ? InverseMatrix() : *this;
+  S21Matrix result, scratch(rows_, cols_);
+  for (; exponent != 0; exponent >>= 1) {
+    if (exponent & 1) {
+      if (result.matrix_ == nullptr) {
+        result = base;
+      } else {
+        Gemm(1.0, result, base, 0.0, scratch);
+        swap(result, scratch);
+      }
+    }
+    if (exponent > 1) {
+      Gemm(1.0, base, base, 0.0, scratch);
+      swap(base, scratch);
+    }
+  }
+  if (result.matrix_ == nullptr) {  // A^0
+    result = S21Matrix(rows_, cols_);
+    for (int i = 0; i < rows_; i++) result.matrix_[i][i] = 1.0;
+  }
+  return result;
+}
+
+S21Matrix S21Matrix::Polynomial(const vector<double>& coefficients) const {
+  if (rows_ != cols_ || rows_ == 0 || coefficients.empty()) throw ERROR_CALC;
+  int degree = coefficients.size() - 1, n = rows_;
+  int step = ceil(sqrt(degree + 1.0));
+  int blocks = degree / step + 1;
+  // p(A) = sum_j B_j * (A^step)^j with B_j = sum_i c[j * step + i] * A^i,
+  // i < step; only A^1..A^step are formed and then Horner runs over j
+  vector<S21Matrix> powers(min(step, degree) + 1);
+  if (degree > 0) powers[1] = *this;
+  for (size_t i = 2; i < powers.size(); i++) {
+    powers[i] = S21Matrix(n, n);
+    Gemm(1.0, powers[i - 1], *this, 0.0, powers[i]);
+  }
+  auto block = [&](int j, S21Matrix& out) {
+    for (int i = 0; i < n; i++) fill(out.matrix_[i], out.matrix_[i] + n, 0.0);
+    for (int i = 0; i < n; i++) out.matrix_[i][i] = coefficients[j * step];
+    for (int i = 1; i < step && j * step + i <= degree; i++)
+      if (coefficients[j * step + i] != 0.0)
+        Axpy(coefficients[j * step + i], powers[i], out);
+  };
+  S21Matrix result(n, n), next(n, n);
+  block(blocks - 1, result);
+  for (int j = blocks - 2; j >= 0; j--) {
+    block(j, next);
+    Gemm(1.0, result, powers[step], 1.0, next);  // B_j + R * A^step
+    swap(result, next);
+  }
+  return result;
+}
+
+static S21Matrix chainOperand(const vector<const S21Matrix*>& factors,
+                              const vector<vector<int>>& split, int i, int j,
+                              vector<vector<double>>& arenas,
+                              vector<double>& arena);
+
+// out = factors[i] * ... * factors[j] with the split chosen by MulChain;
+// intermediates live in arenas that are handed back once consumed
+static void chainProduct(const vector<const S21Matrix*>& factors,
+                         const vector<vector<int>>& split, int i, int j,
+                         S21Matrix& out, vector<vector<double>>& arenas) {
+  int k = split[i][j];
+  vector<double> left_arena, right_arena;
+  S21Matrix left = chainOperand(factors, split, i, k, arenas, left_arena);
+  S21Matrix right = chainOperand(factors, split, k + 1, j, arenas, right_arena);
+  Gemm(1.0, left, right, 0.0, out);
+  if (!left_arena.empty()) arenas.push_back(std::move(left_arena));
+  if (!right_arena.empty()) arenas.push_back(std::move(right_arena));
+}
+
+static S21Matrix chainOperand(const vector<const S21Matrix*>& factors,
+                              const vector<vector<int>>& split, int i, int j,
+                              vector<vector<double>>& arenas,
+                              vector<double>& arena) {
+  if (i == j) {  // a borrowed view of the factor itself
+    const S21Matrix& f = *factors[i];
+    return S21Matrix(const_cast<double*>(f.data()), f.rows(), f.columns(),
+                     f.leadingDimension());
+  }
+  int rows = factors[i]->rows(), cols = factors[j]->columns();
+  size_t size = static_cast<size_t>(rows) * cols;
+  if (!arenas.empty()) {
+    arena = std::move(arenas.back());
+    arenas.pop_back();
+  }
+  if (arena.size() < size) arena.resize(size);
+  S21Matrix result(arena.data(), rows, cols);
+  chainProduct(factors, split, i, j, result, arenas);
+  return result;
+}
+
+S21Matrix MulChain(const vector<const S21Matrix*>& factors) {
+  int n = factors.size();
+  if (n == 0) throw ERROR_CALC;
+  for (int i = 0; i + 1 < n; i++)
+    if (factors[i]->columns() != factors[i + 1]->rows()) throw ERROR_CALC;
+  if (n == 1) return *factors[0];
+  vector<double> dims(n + 1);  // factor i is dims[i] x dims[i + 1]
+  for (int i = 0; i < n; i++) dims[i] = factors[i]->rows();
+  dims[n] = factors[n - 1]->columns();
+  vector<vector<double>> cost(n, vector<double>(n, 0.0));
+  vector<vector<int>> split(n, vector<int>(n, 0));
+  for (int len = 2; len <= n; len++) {  // classic O(n^3) chain-order DP
+    for (int i = 0; i + len - 1 < n; i++) {
+      int j = i + len - 1;
+      cost[i][j] = HUGE_VAL;
+      for (int k = i; k < j; k++) {
+        double c = cost[i][k] + cost[k + 1][j] +
+                   dims[i] * dims[k + 1] * dims[j + 1];
+        if (c < cost[i][j]) cost[i][j] = c, split[i][j] = k;
+      }
+    }
+  }
+  S21Matrix result(factors[0]->rows(), factors[n - 1]->columns());
+  vector<vector<double>> arenas;
+  chainProduct(factors, split, 0, n - 1, result, arenas);
+  return result;
+}
+
+S21Matrix MulChain(initializer_list<reference_wrapper<const S21Matrix>> chain) {
+  vector<const S21Matrix*> factors;
+  for (const S21Matrix& factor : chain) factors.push_back(&factor);
+  return MulChain(factors);
+}
@@ -0,0 +1,177 @@
+#include "s21_matrix_cache.h"
+
+#include <cstring>
+
+using namespace std;
+
+#define HASH_PRIME_1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define HASH_LANES 4
+
+atomic<bool> S21MatrixCache::enabled_(false);
+
+static inline uint64_t hashRound(uint64_t acc, uint64_t input) noexcept {
+  acc += input * HASH_PRIME_2;
+  acc = (acc << 31) | (acc >> 33);
+  return acc * HASH_PRIME_1;
+}
+
+static bool sameContents(const S21Matrix& a, const S21Matrix& b) noexcept {
+  if (a.rows() != b.rows() || a.columns() != b.columns()) return false;
+  size_t row_bytes = sizeof(double) * a.columns();
+  for (int i = 0; i < a.rows(); i++) {
+    const double* ra = a.data() + static_cast<size_t>(i) * a.leadingDimension();
+    const double* rb = b.data() + static_cast<size_t>(i) * b.leadingDimension();
+    if (memcmp(ra, rb, row_bytes) != 0) return false;
+  }
+  return true;
+}
+
+S21MatrixCache::S21MatrixCache() : capacity_(0), stats_{0, 0, 0, 0} {}
+
+S21MatrixCache& S21MatrixCache::instance() {
+  static S21MatrixCache cache;
+  return cache;
+}
+
+// Four independent multiply-rotate lanes over the raw bits, so the loop has
+// no carried dependency between neighbouring elements and vectorizes.
+uint64_t S21MatrixCache::Hash(const S21Matrix& matrix) noexcept {
+  uint64_t lanes[HASH_LANES] = {HASH_PRIME_1, HASH_PRIME_2, 0, ~HASH_PRIME_1};
+  int rows = matrix.rows(), cols = matrix.columns();
+  for (int i = 0; i < rows; i++) {
+    const double* row =
+        matrix.data() + static_cast<size_t>(i) * matrix.leadingDimension();
+    int j = 0;
+    for (; j + HASH_LANES <= cols; j += HASH_LANES) {
+      for (int l = 0; l < HASH_LANES; l++) {
+        uint64_t bits;
+        memcpy(&bits, row + j + l, sizeof(bits));
+        lanes[l] = hashRound(lanes[l], bits);
+      }
+    }
+    for (; j < cols; j++) {
+      uint64_t bits;
+      memcpy(&bits, row + j, sizeof(bits));
+      lanes[j % HASH_LANES] = hashRound(lanes[j % HASH_LANES], bits);
+    }
+  }
+  uint64_t hash = (static_cast<uint64_t>(rows) << 32) | cols;
+  for (int l = 0; l < HASH_LANES; l++) hash = hashRound(hash, lanes[l]);
+  hash ^= hash >> 29;
+  return hash * HASH_PRIME_2;
+}
+
+void S21MatrixCache::Enable(size_t capacity) {
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  cache.capacity_ = capacity;
+  while (cache.lru_.size() > capacity) cache.evictLast();
+  enabled_ = capacity > 0;
+}
+
+void S21MatrixCache::Disable() {
+  enabled_ = false;
+  Clear();
+}
+
+bool S21MatrixCache::Enabled() noexcept { return enabled_; }
+
+void S21MatrixCache::Clear() {
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  cache.index_.clear();
+  cache.lru_.clear();
+  cache.stats_ = {0, 0, 0, 0};
+}
+
+S21CacheStats S21MatrixCache::Stats() {
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  return cache.stats_;
+}
+
+S21MatrixCache::Iterator S21MatrixCache::find(const S21Matrix& matrix,
+                                              uint64_t hash) {
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (sameContents(it->second->key, matrix)) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second;
+    }
+  }
+  return lru_.end();
+}
+
+void S21MatrixCache::evictLast() {
+  Iterator last = prev(lru_.end());
+  auto range = index_.equal_range(last->hash);
+  for (auto victim = range.first; victim != range.second; ++victim) {
+    if (victim->second == last) {
+      index_.erase(victim);
+      break;
+    }
+  }
+  lru_.pop_back();
+  stats_.evictions++;
+  stats_.entries = lru_.size();
+}
+
+S21MatrixCache::Entry& S21MatrixCache::insert(const S21Matrix& matrix,
+                                              uint64_t hash) {
+  Iterator it = find(matrix, hash);
+  if (it != lru_.end()) return *it;
+  if (lru_.size() >= capacity_) evictLast();
+  lru_.push_front(Entry{matrix, hash, false, 0.0, false, S21Matrix()});
+  index_.emplace(hash, lru_.begin());
+  stats_.entries = lru_.size();
+  return lru_.front();
+}
+
+bool S21MatrixCache::FindDeterminant(const S21Matrix& matrix, uint64_t hash,
+                                     double* det) {
+  if (!enabled_) return false;
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  Iterator it = cache.find(matrix, hash);
+  bool hit = it != cache.lru_.end() && it->has_det;
+  if (hit) *det = it->det;
+  hit ? cache.stats_.hits++ : cache.stats_.misses++;
+  return hit;
+}
+
+void S21MatrixCache::StoreDeterminant(const S21Matrix& matrix, uint64_t hash,
+                                      double det) {
+  if (!enabled_) return;
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  if (cache.capacity_ == 0) return;
+  Entry& entry = cache.insert(matrix, hash);
+  entry.has_det = true;
+  entry.det = det;
+}
+
+bool S21MatrixCache::FindInverse(const S21Matrix& matrix, uint64_t hash,
+                                 S21Matrix* inverse) {
+  if (!enabled_) return false;
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  Iterator it = cache.find(matrix, hash);
+  bool hit = it != cache.lru_.end() && it->has_inverse;
+  if (hit) *inverse = it->inverse;
+  hit ? cache.stats_.hits++ : cache.stats_.misses++;
+  return hit;
+}
+
+void S21MatrixCache::StoreInverse(const S21Matrix& matrix, uint64_t hash,
+                                  double det, const S21Matrix& inverse) {
+  if (!enabled_) return;
+  S21MatrixCache& cache = instance();
+  lock_guard<mutex> lock(cache.mutex_);
+  if (cache.capacity_ == 0) return;
+  Entry& entry = cache.insert(matrix, hash);
+  entry.has_det = true;
+  entry.det = det;
+  entry.has_inverse = true;
+  entry.inverse = inverse;
+}
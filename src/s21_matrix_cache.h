@@ -0,0 +1,69 @@
+#ifndef SRC_S21_MATRIX_CACHE_H_
+#define SRC_S21_MATRIX_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "s21_matrix_oop.h"
+
+struct S21CacheStats {
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+  size_t entries;
+};
+
+// Opt-in LRU memo of Determinant() and InverseMatrix() results keyed on the
+// matrix contents. Off by default; hits are confirmed by an exact bitwise
+// comparison, so a hash collision can never return a wrong result.
+class S21MatrixCache {
+ private:
+  struct Entry {
+    S21Matrix key;
+    uint64_t hash;
+    bool has_det;
+    double det;
+    bool has_inverse;
+    S21Matrix inverse;
+  };
+  using Iterator = list<Entry>::iterator;
+
+  mutex mutex_;
+  size_t capacity_;
+  list<Entry> lru_;  // most recently used first
+  unordered_multimap<uint64_t, Iterator> index_;
+  S21CacheStats stats_;
+  static atomic<bool> enabled_;
+
+  S21MatrixCache();
+  static S21MatrixCache& instance();
+  Iterator find(const S21Matrix& matrix, uint64_t hash);
+  Entry& insert(const S21Matrix& matrix, uint64_t hash);
+  void evictLast();
+
+ public:
+  static void Enable(size_t capacity);
+  static void Disable();  // also drops every entry
+  static bool Enabled() noexcept;
+  static void Clear();
+  static S21CacheStats Stats();
+  static uint64_t Hash(const S21Matrix& matrix) noexcept;
+
+  // Callers hash the matrix once per Determinant() or InverseMatrix() call
+  // and pass that hash to exactly one Find, which counts one hit or miss,
+  // and on a miss to one Store. Both results share the matrix's entry.
+  static bool FindDeterminant(const S21Matrix& matrix, uint64_t hash,
+                              double* det);
+  static void StoreDeterminant(const S21Matrix& matrix, uint64_t hash,
+                               double det);
+  // a hit with an empty *inverse means the matrix is known to be singular
+  static bool FindInverse(const S21Matrix& matrix, uint64_t hash,
+                          S21Matrix* inverse);
+  // stores the determinant too; an empty inverse records a singular matrix
+  static void StoreInverse(const S21Matrix& matrix, uint64_t hash, double det,
+                           const S21Matrix& inverse);
+};
+
+#endif  // SRC_S21_MATRIX_CACHE_H_
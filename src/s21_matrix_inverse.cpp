@@ -0,0 +1,136 @@
+#include "s21_matrix_inverse.h"
+
+#include "s21_kernels.h"
+
+using namespace std;
+
+S21Inverse::S21Inverse(const S21Matrix& matrix) : matrix_(matrix), det_(0) {
+  Refactor();
+}
+
+const S21Matrix& S21Inverse::Matrix() const noexcept { return matrix_; }
+
+const S21Matrix& S21Inverse::Inverse() const noexcept { return inverse_; }
+
+double S21Inverse::Determinant() const noexcept { return det_; }
+
+void S21Inverse::Refactor() {
+  int n = matrix_.rows_;
+  if (n == 0 || n != matrix_.cols_) throw ERROR_CALC;
+  vector<int> piv(n);
+  vector<double> lu(n * n), x(n * n, 0.0);
+  packRows(matrix_.matrix_, n, n, lu.data());
+  if (!luFactorTiled(lu.data(), n, piv.data()) || luSingular(lu.data(), n))
+    throw ERROR_CALC;
+  double det = luDeterminant(lu.data(), piv.data(), n);
+  for (int i = 0; i < n; i++) x[i * n + i] = 1.0;
+  luSolve(lu.data(), piv.data(), n, x.data(), n);
+  S21Matrix inverse(n, n);
+  for (int i = 0; i < n; i++)
+    copy(x.begin() + i * n, x.begin() + (i + 1) * n, inverse.matrix_[i]);
+  inverse_ = std::move(inverse);
+  det_ = det;
+}
+
+void S21Inverse::update(const double* u, const double* v) {
+  int n = matrix_.rows_;
+  double** b = inverse_.matrix_;
+  vector<double> bu(n, 0.0), vb(n, 0.0);
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < n; k++) {
+      bu[i] += b[i][k] * u[k];
+      vb[k] += v[i] * b[i][k];
+    }
+  }
+  double denom = 1.0, scale = 1.0;  // 1 + v^T * A^-1 * u and its terms
+  for (int i = 0; i < n; i++) {
+    denom += v[i] * bu[i];
+    scale += fabs(v[i] * bu[i]);
+  }
+  // A + u * v^T is singular when denom is lost in the rounding of its terms
+  if (luSingular(&denom, 1, n * scale)) throw ERROR_CALC;
+  inverse_.detach();
+  matrix_.detach();
+  b = inverse_.matrix_;
+  for (int i = 0; i < n; i++) {
+    double s = bu[i] / denom;
+    for (int j = 0; j < n; j++) b[i][j] -= s * vb[j];
+    for (int j = 0; j < n; j++) matrix_.matrix_[i][j] += u[i] * v[j];
+  }
+  det_ *= denom;
+}
+
+void S21Inverse::RankOneUpdate(const S21Matrix& u, const S21Matrix& v) {
+  int n = matrix_.rows_;
+  if (u.rows_ != n || v.rows_ != n || u.cols_ != 1 || v.cols_ != 1)
+    throw ERROR_CALC;
+  vector<double> uu(n), vv(n);
+  for (int i = 0; i < n; i++) uu[i] = u.matrix_[i][0], vv[i] = v.matrix_[i][0];
+  update(uu.data(), vv.data());
+}
+
+void S21Inverse::ReplaceRow(int r, const S21Matrix& row) {
+  int n = matrix_.rows_;
+  if (r < 0 || r >= n) throw ERROR_MATRIX;
+  if (row.rows_ != 1 || row.cols_ != n) throw ERROR_CALC;
+  vector<double> u(n, 0.0), v(n);
+  u[r] = 1.0;
+  for (int j = 0; j < n; j++) v[j] = row.matrix_[0][j] - matrix_.matrix_[r][j];
+  update(u.data(), v.data());
+}
+
+void S21Inverse::ReplaceColumn(int c, const S21Matrix& column) {
+  int n = matrix_.rows_;
+  if (c < 0 || c >= n) throw ERROR_MATRIX;
+  if (column.rows_ != n || column.cols_ != 1) throw ERROR_CALC;
+  vector<double> u(n), v(n, 0.0);
+  v[c] = 1.0;
+  for (int i = 0; i < n; i++)
+    u[i] = column.matrix_[i][0] - matrix_.matrix_[i][c];
+  update(u.data(), v.data());
+}
+
+void S21Inverse::RankKUpdate(const S21Matrix& u, const S21Matrix& v) {
+  int n = matrix_.rows_, k = u.cols_;
+  if (u.rows_ != n || v.rows_ != n || v.cols_ != k) throw ERROR_CALC;
+  double** b = inverse_.matrix_;
+  vector<double> bu(n * k, 0.0), vb(k * n, 0.0), s(k * k, 0.0);
+  for (int i = 0; i < n; i++) {
+    for (int l = 0; l < n; l++) {
+      for (int p = 0; p < k; p++) {
+        bu[i * k + p] += b[i][l] * u.matrix_[l][p];
+        vb[p * n + l] += v.matrix_[i][p] * b[i][l];
+      }
+    }
+  }
+  double scale = 1.0;  // largest row of |I| + |V^T| * |B * U|
+  for (int p = 0; p < k; p++) {  // S = I + V^T * B * U
+    s[p * k + p] = 1.0;
+    double row = 1.0;
+    for (int i = 0; i < n; i++) {
+      for (int q = 0; q < k; q++) {
+        s[p * k + q] += v.matrix_[i][p] * bu[i * k + q];
+        row += fabs(v.matrix_[i][p] * bu[i * k + q]);
+      }
+    }
+    scale = max(scale, row);
+  }
+  vector<int> piv(k);
+  if (!luFactor(s.data(), k, piv.data()) ||
+      luSingular(s.data(), k, n * scale / k))
+    throw ERROR_CALC;
+  double det = det_ * luDeterminant(s.data(), piv.data(), k);
+  luSolve(s.data(), piv.data(), k, vb.data(), n);  // vb = S^-1 * V^T * B
+  inverse_.detach();
+  matrix_.detach();
+  b = inverse_.matrix_;
+  for (int i = 0; i < n; i++) {
+    for (int p = 0; p < k; p++) {
+      double bip = bu[i * k + p];
+      for (int j = 0; j < n; j++) b[i][j] -= bip * vb[p * n + j];
+      for (int j = 0; j < n; j++)
+        matrix_.matrix_[i][j] += u.matrix_[i][p] * v.matrix_[j][p];
+    }
+  }
+  det_ = det;
+}
@@ -0,0 +1,31 @@
+#ifndef SRC_S21_MATRIX_INVERSE_H_
+#define SRC_S21_MATRIX_INVERSE_H_
+
+#include "s21_matrix_oop.h"
+
+// Keeps A, its inverse and determinant, and maintains them under low-rank
+// changes of A (Sherman-Morrison / Woodbury) in O(n^2) per rank-1 update.
+// Updates that would make A singular throw ERROR_CALC and leave the object
+// unchanged; Refactor() recomputes from A to flush accumulated rounding.
+class S21Inverse {
+ private:
+  S21Matrix matrix_;
+  S21Matrix inverse_;
+  double det_;
+  void update(const double* u, const double* v);  // A += u * v^T
+
+ public:
+  explicit S21Inverse(const S21Matrix& matrix);
+
+  const S21Matrix& Matrix() const noexcept;
+  const S21Matrix& Inverse() const noexcept;
+  double Determinant() const noexcept;
+
+  void RankOneUpdate(const S21Matrix& u, const S21Matrix& v);  // n x 1 each
+  void RankKUpdate(const S21Matrix& u, const S21Matrix& v);    // n x k each
+  void ReplaceRow(int r, const S21Matrix& row);                // 1 x n
+  void ReplaceColumn(int c, const S21Matrix& column);          // n x 1
+  void Refactor();
+};
+
+#endif  // SRC_S21_MATRIX_INVERSE_H_
@@ -0,0 +1,214 @@
+#include "s21_matrix_io.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static const char* skipBlanks(const char* p, const char* end) {
+  while (p < end && isBlank(*p)) p++;
+  return p;
+}
+
+// Parses up to cols fields of [p, end) into out (nullptr only counts them);
+// returns the field count, or -1 if the line is malformed or too long
+static int parseLine(const char* p, const char* end, char delimiter,
+                     double* out, int cols) {
+  int count = 0;
+  p = skipBlanks(p, end);
+  while (p < end) {
+    if (count > 0) {
+      if (delimiter == ' ') {
+        if (!isBlank(p[-1])) return -1;
+      } else {
+        if (*p != delimiter) return -1;
+        p = skipBlanks(p + 1, end);
+      }
+    }
+    if (count == cols) return -1;
+    // from_chars takes '-' but not '+'; "+-3" must stay malformed
+    if (end - p > 1 && *p == '+' && p[1] != '-' && p[1] != '+') p++;
+    double value;
+    auto [next, error] = from_chars(p, end, value);
+    if (error != errc()) return -1;
+    if (out != nullptr) out[count] = value;
+    count++;
+    p = skipBlanks(next, end);
+  }
+  return count;
+}
+
+static bool blankLine(const char* p, const char* end) {
+  return skipBlanks(p, end) == end;
+}
+
+// Calls f(begin, end) for each non-blank line of [p, end)
+template <typename F>
+static void forEachLine(const char* p, const char* end, F f) {
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr) eol = end;
+    if (!blankLine(p, eol)) f(p, eol);
+    p = eol + 1;
+  }
+}
+
+static void parse(string_view text, char delimiter, S21Matrix* matrix,
+                  bool preallocated) {
+  const char* begin = text.data();
+  const char* end = begin + text.size();
+  int cols = 0;
+  for (const char* p = begin; p < end && cols == 0;) {  // first row's width
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr) eol = end;
+    cols = parseLine(p, eol, delimiter, nullptr, INT_MAX);
+    p = eol + 1;
+  }
+  if (cols < 0) throw ERROR_MATRIX;
+  // chunks start right after a newline, so no line is split between them
+  S21Executor& executor = S21Executor::Instance();
+  size_t target = max<size_t>(1 << 16, text.size() / (4 * executor.threads()));
+  vector<const char*> starts = {begin};
+  while (end - starts.back() > static_cast<ptrdiff_t>(target)) {
+    const char* p = starts.back() + target;
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr) break;
+    starts.push_back(eol + 1);
+  }
+  int chunks = starts.size();
+  starts.push_back(end);
+  vector<int> first_row(chunks + 1, 0);
+  executor.ParallelFor(chunks, 1, [&](int from, int to) {
+    for (int c = from; c < to; c++)
+      forEachLine(starts[c], starts[c + 1], [&](const char*, const char*) {
+        first_row[c + 1]++;
+      });
+  });
+  for (int c = 0; c < chunks; c++) first_row[c + 1] += first_row[c];
+  int rows = first_row[chunks];
+  if (rows == 0 && !preallocated) {
+    *matrix = S21Matrix();
+    return;
+  }
+  if (preallocated) {
+    if (matrix->rows() != rows || matrix->columns() != cols) throw ERROR_CALC;
+  } else {
+    *matrix = S21Matrix(rows, cols);
+  }
+  double* data = matrix->data();
+  int ld = matrix->leadingDimension();
+  atomic<bool> malformed(false);
+  executor.ParallelFor(chunks, 1, [&](int from, int to) {
+    for (int c = from; c < to; c++) {
+      int row = first_row[c];
+      forEachLine(starts[c], starts[c + 1], [&](const char* p, const char* e) {
+        double* out = data + static_cast<size_t>(row++) * ld;
+        if (parseLine(p, e, delimiter, out, cols) != cols) malformed = true;
+      });
+    }
+  });
+  if (malformed) throw ERROR_MATRIX;
+}
+
+S21Matrix ReadMatrix(string_view text, char delimiter) {
+  S21Matrix result;
+  parse(text, delimiter, &result, false);
+  return result;
+}
+
+void ReadMatrix(string_view text, S21Matrix& matrix, char delimiter) {
+  parse(text, delimiter, &matrix, true);
+}
+
+S21Matrix ReadMatrixFile(const string& path, char delimiter) {
+  ifstream in(path, ios::binary);
+  if (!in) throw ERROR_MATRIX;
+  string text;
+  in.seekg(0, ios::end);
+  streamoff size = in.tellg();
+  if (size >= 0) {  // a regular file: one read of the known size
+    text.resize(size);
+    in.seekg(0, ios::beg);
+    in.read(text.data(), text.size());
+    if (!in) throw ERROR_MATRIX;
+  } else {  // pipes and FIFOs cannot seek, so drain the buffer instead
+    in.clear();
+    ostringstream buffer;
+    if (in.peek() != char_traits<char>::eof() && !(buffer << in.rdbuf()))
+      throw ERROR_MATRIX;
+    text = buffer.str();
+  }
+  return ReadMatrix(text, delimiter);
+}
+
+void WriteMatrix(ostream& out, const S21Matrix& matrix, char delimiter) {
+  int rows = matrix.rows(), cols = matrix.columns();
+  if (rows == 0) return;
+  const double* data = matrix.data();
+  int ld = matrix.leadingDimension();
+  S21Executor& executor = S21Executor::Instance();
+  int chunk = max(1, (1 << 14) / cols);  // rows formatted per task
+  int batch = chunk * 4 * executor.threads();  // rows held before writing
+  const size_t kField = 25;  // "-1.2345678901234567e-308" plus delimiter
+  vector<string> text((batch + chunk - 1) / chunk);
+  for (int first = 0; first < rows; first += batch) {
+    int count = min(batch, rows - first);
+    int tasks = (count + chunk - 1) / chunk;
+    executor.ParallelFor(tasks, 1, [&](int from, int to) {
+      for (int t = from; t < to; t++) {
+        int begin = first + t * chunk, end = min(first + count, begin + chunk);
+        string& buffer = text[t];
+        buffer.resize(static_cast<size_t>(end - begin) * cols * kField);
+        char* p = buffer.data();
+        for (int i = begin; i < end; i++) {
+          const double* row = data + static_cast<size_t>(i) * ld;
+          for (int j = 0; j < cols; j++) {
+            if (j > 0) *p++ = delimiter;
+            p = to_chars(p, p + kField, row[j]).ptr;
+          }
+          *p++ = '\n';
+        }
+        buffer.resize(p - buffer.data());
+      }
+    });
+    for (int t = 0; t < tasks; t++) out.write(text[t].data(), text[t].size());
+  }
+  if (!out) throw ERROR_MATRIX;
+}
+
+void WriteMatrixFile(const string& path, const S21Matrix& matrix,
+                     char delimiter) {
+  ofstream out(path, ios::binary);
+  if (!out) throw ERROR_MATRIX;
+  WriteMatrix(out, matrix, delimiter);
+}
+
+S21MatrixReader::S21MatrixReader(istream& in, char delimiter)
+    : in_(in), delimiter_(delimiter), cols_(0) {}
+
+int S21MatrixReader::columns() const noexcept { return cols_; }
+
+bool S21MatrixReader::Next(S21Matrix& row) {
+  do {
+    if (!getline(in_, line_)) return false;
+  } while (blankLine(line_.data(), line_.data() + line_.size()));
+  const char* begin = line_.data();
+  const char* end = begin + line_.size();
+  if (cols_ == 0) {
+    cols_ = parseLine(begin, end, delimiter_, nullptr, INT_MAX);
+    if (cols_ < 0) {
+      cols_ = 0;
+      throw ERROR_MATRIX;
+    }
+  }
+  if (row.rows() != 1 || row.columns() != cols_) row = S21Matrix(1, cols_);
+  if (parseLine(begin, end, delimiter_, row.data(), cols_) != cols_)
+    throw ERROR_MATRIX;
+  return true;
+}
@@ -0,0 +1,42 @@
+#ifndef SRC_S21_MATRIX_IO_H_
+#define SRC_S21_MATRIX_IO_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Text matrices: one row per line, fields separated by delimiter, or by
+// runs of blanks when delimiter is ' '. Blank lines are skipped, every row
+// must have the same number of fields and malformed input throws
+// ERROR_MATRIX. Parsing uses from_chars on chunks of the text in parallel.
+S21Matrix ReadMatrix(string_view text, char delimiter = ',');
+// fills an already allocated matrix in place; another shape is ERROR_CALC
+void ReadMatrix(string_view text, S21Matrix& matrix, char delimiter = ',');
+S21Matrix ReadMatrixFile(const string& path, char delimiter = ',');
+
+// shortest round-trip to_chars formatting, row blocks formatted in parallel
+void WriteMatrix(ostream& out, const S21Matrix& matrix, char delimiter = ',');
+void WriteMatrixFile(const string& path, const S21Matrix& matrix,
+                     char delimiter = ',');
+
+// Row-at-a-time reading from a stream for inputs that should not be held
+// in memory; Next reuses the row's buffer once its shape is set.
+class S21MatrixReader {
+ private:
+  istream& in_;
+  char delimiter_;
+  int cols_;
+  string line_;
+
+ public:
+  explicit S21MatrixReader(istream& in, char delimiter = ',');
+
+  bool Next(S21Matrix& row);  // 1 x columns(), false at the end
+  int columns() const noexcept;  // set by the first row, 0 before it
+};
+
+#endif  // SRC_S21_MATRIX_IO_H_
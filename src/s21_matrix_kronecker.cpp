@@ -0,0 +1,76 @@
+#include "s21_matrix_kronecker.h"
+
+#include <algorithm>
+
+using namespace std;
+
+S21Matrix Kronecker(const S21Matrix& a, const S21Matrix& b) {
+  int m = a.rows(), n = a.columns(), p = b.rows(), q = b.columns();
+  if (m == 0 || n == 0 || p == 0 || q == 0) throw ERROR_CALC;
+  S21Matrix result(m * p, n * q);
+  double* out = result.data();
+  const double* pa = a.data();
+  const double* pb = b.data();
+  int ld = result.leadingDimension(), lda = a.leadingDimension(),
+      ldb = b.leadingDimension();
+  int chunk = max(1, (1 << 16) / (n * q));  // output rows per task
+  S21Executor::Instance().ParallelFor(m * p, chunk, [&](int begin, int end) {
+    for (int r = begin; r < end; r++) {  // row r = (i, k): A(i, :) x B(k, :)
+      const double* ai = pa + static_cast<size_t>(r / p) * lda;
+      const double* bk = pb + static_cast<size_t>(r % p) * ldb;
+      double* row = out + static_cast<size_t>(r) * ld;
+      for (int j = 0; j < n; j++, row += q) {
+        double s = ai[j];
+        for (int l = 0; l < q; l++) row[l] = s * bk[l];
+      }
+    }
+  });
+  return result;
+}
+
+S21Matrix Hadamard(const S21Matrix& a, const S21Matrix& b) {
+  return a.Zip(b, [](double x, double y) { return x * y; });
+}
+
+S21KroneckerOperator::S21KroneckerOperator(const S21Matrix& a,
+                                           const S21Matrix& b)
+    : a_(a), b_(b) {
+  if (a.rows() == 0 || a.columns() == 0 || b.rows() == 0 ||
+      b.columns() == 0)
+    throw ERROR_CALC;
+}
+
+int S21KroneckerOperator::rows() const noexcept {
+  return a_.rows() * b_.rows();
+}
+
+int S21KroneckerOperator::columns() const noexcept {
+  return a_.columns() * b_.columns();
+}
+
+S21Matrix S21KroneckerOperator::ToMatrix() const { return Kronecker(a_, b_); }
+
+S21Matrix S21KroneckerOperator::operator*(const S21Matrix& x) const {
+  int m = a_.rows(), n = a_.columns(), p = b_.rows(), q = b_.columns();
+  if (x.rows() != n * q) throw ERROR_CALC;
+  int k = x.columns();
+  S21Matrix result(m * p, k), in(n, q), out(m, p);
+  // cheaper association of A * X * B^T
+  bool left_first = static_cast<double>(m) * q * (n + p) <=
+                    static_cast<double>(n) * p * (q + m);
+  S21Matrix temp = left_first ? S21Matrix(m, q) : S21Matrix(n, p);
+  for (int c = 0; c < k; c++) {
+    for (int j = 0; j < n; j++)
+      for (int l = 0; l < q; l++) in(j, l) = x(j * q + l, c);
+    if (left_first) {
+      Gemm(1.0, a_, in, 0.0, temp);
+      Gemm(1.0, temp, b_, 0.0, out, false, true);
+    } else {
+      Gemm(1.0, in, b_, 0.0, temp, false, true);
+      Gemm(1.0, a_, temp, 0.0, out);
+    }
+    for (int i = 0; i < m; i++)
+      for (int l = 0; l < p; l++) result(i * p + l, c) = out(i, l);
+  }
+  return result;
+}
@@ -0,0 +1,29 @@
+#ifndef SRC_S21_MATRIX_KRONECKER_H_
+#define SRC_S21_MATRIX_KRONECKER_H_
+
+#include "s21_matrix_oop.h"
+
+// (m x n) kron (p x q) = mp x nq, written one contiguous output row at a
+// time; S21KroneckerOperator multiplies by it without forming it
+S21Matrix Kronecker(const S21Matrix& a, const S21Matrix& b);
+// element-wise product of two matrices of the same shape
+S21Matrix Hadamard(const S21Matrix& a, const S21Matrix& b);
+
+// A kron B kept as its factors. With x reshaped row-major into the n x q
+// matrix X, (A kron B) * x is A * X * B^T reshaped back, which costs
+// O(mnq + mpq) per column instead of O(mnpq) and never stores mp x nq.
+class S21KroneckerOperator {
+ private:
+  S21Matrix a_;
+  S21Matrix b_;
+
+ public:
+  S21KroneckerOperator(const S21Matrix& a, const S21Matrix& b);
+
+  int rows() const noexcept;     // a.rows() * b.rows()
+  int columns() const noexcept;  // a.columns() * b.columns()
+  S21Matrix ToMatrix() const;
+  S21Matrix operator*(const S21Matrix& x) const;  // columns() x k
+};
+
+#endif  // SRC_S21_MATRIX_KRONECKER_H_
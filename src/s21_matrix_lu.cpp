@@ -0,0 +1,137 @@
+#include <algorithm>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+using namespace std;
+
+static const int kLuBlock = 96;
+
+template <typename T>
+static T* row(T* a, int n, int i) {
+  return a + static_cast<size_t>(i) * n;
+}
+
+// Partial-pivoting LU of columns [col, col + width) over rows col..n-1; the
+// row swaps are applied to these columns only
+template <typename T>
+static void factorPanel(T* a, int n, int col, int width, int* piv,
+                        atomic<bool>& singular) {
+  for (int k = col; k < col + width; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++)
+      if (fabs(row(a, n, i)[k]) > fabs(row(a, n, p)[k])) p = i;
+    piv[k] = p;
+    T* rk = row(a, n, k);
+    if (p != k) swap_ranges(rk + col, rk + col + width, row(a, n, p) + col);
+    if (rk[k] == T(0)) {
+      singular = true;
+      continue;
+    }
+    T inv = T(1) / rk[k];
+    for (int i = k + 1; i < n; i++) {
+      T* ri = row(a, n, i);
+      T l = ri[k] *= inv;
+      if (l == T(0)) continue;
+      for (int j = k + 1; j < col + width; j++) ri[j] -= l * rk[j];
+    }
+  }
+}
+
+// c -= l * u on blocks of an n x n row-major buffer
+static void subtractProduct(const double* l, const double* u, double* c,
+                            int rows, int depth, int cols, int n) {
+  S21Matrix lv(const_cast<double*>(l), rows, depth, n);
+  S21Matrix uv(const_cast<double*>(u), depth, cols, n);
+  S21Matrix cv(c, rows, cols, n);
+  Gemm(-1.0, lv, uv, 1.0, cv);
+}
+
+static void subtractProduct(const float* l, const float* u, float* c,
+                            int rows, int depth, int cols, int n) {
+  gemmFloat(rows, cols, depth, -1.0f, l, n, u, n, c, n);
+}
+
+// Brings column block [jcol, jcol + jw) up to date with panel [col, col + w):
+// row swaps, U = L^-1 * A on the panel rows, then A -= L * U below them
+template <typename T>
+static void updateBlock(T* a, int n, int col, int w, int jcol, int jw,
+                        const int* piv) {
+  for (int k = col; k < col + w; k++) {
+    if (piv[k] == k) continue;
+    T* rk = row(a, n, k) + jcol;
+    swap_ranges(rk, rk + jw, row(a, n, piv[k]) + jcol);
+  }
+  for (int i = col + 1; i < col + w; i++) {
+    T* ri = row(a, n, i);
+    for (int p = col; p < i; p++) {
+      T l = ri[p];
+      if (l == T(0)) continue;
+      const T* rp = row(a, n, p);
+      for (int j = jcol; j < jcol + jw; j++) ri[j] -= l * rp[j];
+    }
+  }
+  int below = n - col - w;
+  if (below == 0) return;
+  subtractProduct(row(a, n, col + w) + col, row(a, n, col) + jcol,
+                  row(a, n, col + w) + jcol, below, w, jw, n);
+}
+
+template <typename T>
+bool luFactorTiled(T* a, int n, int* piv) {
+  if (n < 2 * kLuBlock) return luFactor(a, n, piv);
+  int blocks = (n + kLuBlock - 1) / kLuBlock;
+  atomic<bool> singular(false);
+  S21TaskGraph graph;
+  vector<int> last(blocks, -1);  // latest task writing each column block
+  for (int k = 0; k < blocks; k++) {
+    int col = k * kLuBlock, w = min(kLuBlock, n - col);
+    int panel = graph.Add(
+        [=, &singular] { factorPanel(a, n, col, w, piv, singular); });
+    if (last[k] >= 0) graph.Depend(panel, last[k]);
+    last[k] = panel;
+    // right to left, so the worker finishing the panel pops the update of
+    // block k + 1 (the next panel's only input) first
+    for (int j = blocks - 1; j > k; j--) {
+      int jcol = j * kLuBlock, jw = min(kLuBlock, n - jcol);
+      int update =
+          graph.Add([=] { updateBlock(a, n, col, w, jcol, jw, piv); });
+      graph.Depend(update, panel);
+      if (last[j] >= 0) graph.Depend(update, last[j]);
+      last[j] = update;
+    }
+  }
+  graph.Run();
+  for (int k = kLuBlock; k < n; k++)  // later swaps on the columns of L
+    if (piv[k] != k) {
+      int col = k / kLuBlock * kLuBlock;
+      swap_ranges(row(a, n, k), row(a, n, k) + col, row(a, n, piv[k]));
+    }
+  return !singular;
+}
+
+template <typename T>
+void luSolveColumns(const T* lu, const int* piv, int n, T* b, int nrhs) {
+  const int width = 64;  // right-hand sides solved per task
+  if (nrhs <= width) return luSolve(lu, piv, n, b, nrhs);
+  S21Executor::Instance().ParallelFor(
+      (nrhs + width - 1) / width, 1, [&](int begin, int end) {
+        vector<T> x;
+        for (int block = begin; block < end; block++) {
+          int col = block * width, w = min(width, nrhs - col);
+          x.resize(static_cast<size_t>(n) * w);
+          for (int i = 0; i < n; i++)
+            copy_n(b + static_cast<size_t>(i) * nrhs + col, w, &x[i * w]);
+          luSolve(lu, piv, n, x.data(), w);
+          for (int i = 0; i < n; i++)
+            copy_n(&x[i * w], w, b + static_cast<size_t>(i) * nrhs + col);
+        }
+      });
+}
+
+template bool luFactorTiled<double>(double* a, int n, int* piv);
+template bool luFactorTiled<float>(float* a, int n, int* piv);
+template void luSolveColumns<double>(const double* lu, const int* piv, int n,
+                                     double* b, int nrhs);
+template void luSolveColumns<float>(const float* lu, const int* piv, int n,
+                                    float* b, int nrhs);
@@ -1,5 +1,8 @@
 #include "s21_matrix_oop.h"
 
+#include "s21_kernels.h"
+#include "s21_matrix_cache.h"
+
 using namespace std;
 
 S21Matrix S21Matrix::getMinor(int r_minor, int c_minor) const noexcept {
@@ -18,80 +21,282 @@ S21Matrix S21Matrix::getMinor(int r_minor, int c_minor) const noexcept {
   return result;
 }
 
+atomic<bool> S21Matrix::copy_on_write_(false);
+
+S21Matrix::Storage::Storage(double* data, Deleter free, bool adopted)
+    : data(data), free(std::move(free)), owners(1), adopted(adopted) {}
+
+void S21Matrix::allocate(int rows, int cols) {
+  rows_ = 0;
+  cols_ = 0;
+  matrix_ = nullptr;
+  storage_ = nullptr;
+  unshareable_ = false;
+  reallocate(rows, cols);
+  rows_ = rows;
+  cols_ = cols;
+}
+
+void S21Matrix::reallocate(int row_cap, int col_cap) {
+  size_t size = static_cast<size_t>(row_cap) * col_cap;
+  Storage* storage =
+      new Storage(new double[size](), default_delete<double[]>());
+  double** rows = new double*[row_cap];
+  for (int i = 0; i < row_cap; i++)
+    rows[i] = storage->data + static_cast<size_t>(i) * col_cap;
+  for (int i = 0; i < rows_; i++)
+    copy(matrix_[i], matrix_[i] + cols_, rows[i]);
+  delete[] matrix_;
+  matrix_ = rows;
+  dropStorage();
+  storage_ = storage;
+  unshareable_ = false;  // references into the old buffer are invalid now
+  row_cap_ = row_cap;
+  col_cap_ = col_cap;
+}
+
+void S21Matrix::dropStorage() noexcept {
+  // acq_rel: the last owner sees every other owner's accesses before freeing
+  if (storage_ != nullptr &&
+      storage_->owners.fetch_sub(1, memory_order_acq_rel) == 1) {
+    if (storage_->free) storage_->free(storage_->data);
+    delete storage_;
+  }
+  storage_ = nullptr;
+}
+
+void S21Matrix::freeMatrix() noexcept {
+  delete[] matrix_;
+  matrix_ = nullptr;
+  dropStorage();
+  unshareable_ = false;
+  rows_ = 0;
+  cols_ = 0;
+  row_cap_ = 0;
+  col_cap_ = 0;
+}
+
+void S21Matrix::copyFrom(const S21Matrix& other) {
+  if (other.matrix_ == nullptr) return;
+  if (copy_on_write_ && !other.unshareable_) {  // detach on first write
+    rows_ = row_cap_ = other.rows_;  // only rows_ row pointers exist
+    cols_ = other.cols_;
+    col_cap_ = other.leadingDimension();  // the shared buffer's real stride
+    storage_ = other.storage_;
+    storage_->owners.fetch_add(1, memory_order_relaxed);
+    matrix_ = new double*[rows_];
+    for (int i = 0; i < rows_; i++) matrix_[i] = other.matrix_[i];
+  } else {
+    allocate(other.rows_, other.cols_);
+    for (int i = 0; i < rows_; i++)
+      copy(other.matrix_[i], other.matrix_[i] + cols_, matrix_[i]);
+  }
+}
+
+void S21Matrix::detach() {
+  // acquire pairs with the release in dropStorage of the other owners, so
+  // their reads of the buffer happen before the writes that follow
+  if (storage_ == nullptr ||
+      storage_->owners.load(memory_order_acquire) == 1)
+    return;
+  reallocate(rows_, cols_);
+}
+
+void S21Matrix::takeFrom(S21Matrix& other) noexcept {
+  rows_ = other.rows_, cols_ = other.cols_, matrix_ = other.matrix_;
+  row_cap_ = other.row_cap_, col_cap_ = other.col_cap_;
+  storage_ = other.storage_, unshareable_ = other.unshareable_;
+  other.rows_ = 0, other.cols_ = 0, other.matrix_ = nullptr;
+  other.row_cap_ = 0, other.col_cap_ = 0;
+  other.storage_ = nullptr, other.unshareable_ = false;
+}
+
+void S21Matrix::SetCopyOnWrite(bool enabled) noexcept {
+  copy_on_write_ = enabled;
+}
+
+bool S21Matrix::CopyOnWrite() noexcept { return copy_on_write_; }
+
+bool S21Matrix::isShared() const noexcept {
+  return storage_ != nullptr &&
+         storage_->owners.load(memory_order_acquire) > 1;
+}
+
 S21Matrix::S21Matrix() {
   rows_ = 0;
   cols_ = 0;
+  row_cap_ = 0;
+  col_cap_ = 0;
   matrix_ = nullptr;
+  storage_ = nullptr;
+  unshareable_ = false;
 }
 
 S21Matrix::S21Matrix(int rows, int cols) {  // parametric constructor
   if (rows <= 0 || cols <= 0) throw ERROR_MATRIX;
-  rows_ = rows;
-  cols_ = cols;
-  matrix_ = new double*[rows_];
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_];
-    for (int j = 0; j < cols_; j++) matrix_[i][j] = 0.0;
-  }
+  allocate(rows, cols);
 }
 
-S21Matrix::S21Matrix(const S21Matrix& other) {  // copy constructor
-  rows_ = other.rows();
-  cols_ = other.columns();
-  matrix_ = new double*[rows_];
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_];
-  }
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = other(i, j);
-    }
-  }
+S21Matrix::S21Matrix(const S21Matrix& other) : S21Matrix() {  // copy
+  copyFrom(other);
 }
 
 S21Matrix::S21Matrix(S21Matrix&& other) noexcept {  // transfer constructor
-  rows_ = other.rows(), cols_ = other.columns(), matrix_ = other.matrix_;
-  ;
-  other.rows_ = 0, other.cols_ = 0, other.matrix_ = nullptr;
+  takeFrom(other);
 }
 
-S21Matrix::~S21Matrix() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; i++) delete[] matrix_[i];
-    delete[] matrix_;  // Destructor
-  }
+S21Matrix::S21Matrix(double* data, int rows, int cols, int ld,
+                     Deleter deleter)
+    : S21Matrix() {
+  if (ld == 0) ld = cols;
+  if (data == nullptr || rows <= 0 || cols <= 0 || ld < cols)
+    throw ERROR_MATRIX;
+  storage_ = new Storage(data, std::move(deleter), true);
+  unshareable_ = true;  // the caller still holds a pointer into it
+  matrix_ = new double*[rows];
+  for (int i = 0; i < rows; i++)
+    matrix_[i] = data + static_cast<size_t>(i) * ld;
+  rows_ = row_cap_ = rows;  // growth reallocates: the padding is not ours
+  cols_ = col_cap_ = cols;
 }
 
+S21Matrix::~S21Matrix() { freeMatrix(); }
+
 int S21Matrix::rows() const noexcept { return rows_; }
 
 int S21Matrix::columns() const noexcept { return cols_; }
 
+int S21Matrix::capacityRows() const noexcept { return row_cap_; }
+
+int S21Matrix::capacityColumns() const noexcept { return col_cap_; }
+
 void S21Matrix::setRows(int r) {
-  if (r <= 0) throw ERROR_MATRIX;
-  S21Matrix result(r, cols_);
-  for (int i = 0; i < r; i++) {
-    for (int j = 0; j < cols_; j++) {
-      if (i >= rows_)
-        result.matrix_[i][j] = 0.0;
-      else
-        result.matrix_[i][j] = matrix_[i][j];
-    }
-  }
-  *this = result;
+  if (r <= 0 || cols_ <= 0) throw ERROR_MATRIX;
+  detach();
+  if (r > row_cap_) reallocate(max(r, 2 * row_cap_), col_cap_);
+  for (int i = rows_; i < r; i++) fill(matrix_[i], matrix_[i] + cols_, 0.0);
+  rows_ = r;
 }
 
 void S21Matrix::setColumns(int c) {
-  if (c <= 0) throw ERROR_MATRIX;
-  S21Matrix result(rows_, c);
+  if (c <= 0 || rows_ <= 0) throw ERROR_MATRIX;
+  detach();
+  if (c > col_cap_) reallocate(row_cap_, max(c, 2 * col_cap_));
+  for (int i = 0; i < rows_ && c > cols_; i++)
+    fill(matrix_[i] + cols_, matrix_[i] + c, 0.0);
+  cols_ = c;
+}
+
+void S21Matrix::reserve(int rows, int cols) {
+  if (rows <= 0 || cols <= 0) throw ERROR_MATRIX;
+  detach();
+  if (rows > row_cap_ || cols > col_cap_)
+    reallocate(max(rows, row_cap_), max(cols, col_cap_));
+}
+
+void S21Matrix::shrinkToFit() {
+  if (rows_ < row_cap_ || cols_ < col_cap_) reallocate(rows_, cols_);
+}
+
+void S21Matrix::appendRow(const double* values, int count) {
+  if (count <= 0 || (cols_ != 0 && count != cols_)) throw ERROR_CALC;
+  detach();
+  vector<double> staged;  // values may point into the buffer being replaced
+  if (rows_ == row_cap_ || count > col_cap_) {  // reserve() may be narrower
+    staged.assign(values, values + count);
+    values = staged.data();
+    reallocate(rows_ == row_cap_ ? max(1, 2 * row_cap_) : row_cap_,
+               max(count, col_cap_));
+  }
+  if (cols_ == 0) cols_ = count;
+  copy(values, values + cols_, matrix_[rows_]);
+  rows_++;
+}
+
+double* S21Matrix::data() {
+  detach();
+  unshareable_ = matrix_ != nullptr;
+  return matrix_ == nullptr ? nullptr : matrix_[0];
+}
+
+const double* S21Matrix::data() const noexcept {
+  return matrix_ == nullptr ? nullptr : matrix_[0];
+}
+
+int S21Matrix::leadingDimension() const noexcept {
+  if (matrix_ == nullptr) return 0;
+  return rows_ > 1 ? static_cast<int>(matrix_[1] - matrix_[0]) : cols_;
+}
+
+double* S21Matrix::release(int* ld) {
+  if (matrix_ == nullptr) return nullptr;
+  if (storage_->adopted && !storage_->free) throw ERROR_MATRIX;
+  bool padded =
+      rows_ < row_cap_ || cols_ < col_cap_ || leadingDimension() != cols_;
+  if (!storage_->adopted && (padded || isShared()))  // adopted: never shared
+    reallocate(rows_, cols_);
+  if (ld != nullptr) *ld = leadingDimension();
+  double* data = storage_->data;
+  storage_->free = nullptr;
+  freeMatrix();
+  return data;
+}
+
+void S21Matrix::appendRow(const S21Matrix& row) {
+  if (row.rows_ != 1) throw ERROR_CALC;
+  if (&row == this) return appendRow(S21Matrix(row));
+  appendRow(row.matrix_[0], row.cols_);
+}
+
+void S21Matrix::Bandwidth(int* lower, int* upper) const noexcept {
+  *lower = 0;
+  *upper = 0;
   for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < c; j++) {
-      if (j >= cols_)
-        result.matrix_[i][j] = 0.0;
-      else
-        result.matrix_[i][j] = matrix_[i][j];
-    }
+    const double* row = matrix_[i];
+    int first = 0, last = cols_ - 1;
+    while (first < cols_ && row[first] == 0.0) first++;
+    if (first == cols_) continue;
+    while (row[last] == 0.0) last--;
+    *lower = max(*lower, i - first);
+    *upper = max(*upper, last - i);
   }
-  *this = result;
+}
+
+S21Matrix::Structure S21Matrix::DetectStructure() const noexcept {
+  int lower, upper;
+  Bandwidth(&lower, &upper);
+  if (lower == 0 && upper == 0) return kDiagonal;
+  if (lower == 0) return kUpperTriangular;
+  if (upper == 0) return kLowerTriangular;
+  if (2 * (lower + upper + 1) <= cols_) return kBanded;
+  return kGeneral;
+}
+
+double S21Matrix::Trace() const {
+  if (rows_ != cols_) throw ERROR_CALC;
+  double result = 0.0;
+  for (int i = 0; i < rows_; i++) result += matrix_[i][i];
+  return result;
+}
+
+double S21Matrix::NormFrobenius() const {
+  return sqrt(MapReduce(
+      0.0, [](double x) { return x * x; },
+      [](double acc, double x) { return acc + x; }));
+}
+
+double S21Matrix::NormMax() const {
+  return MapReduce(
+      0.0, [](double x) { return fabs(x); },
+      [](double acc, double x) { return fmax(acc, x); });
+}
+
+double S21Matrix::Norm1() const {
+  if (matrix_ == nullptr) return 0.0;
+  S21Matrix sums = MapReduce(
+      0.0, [](double x) { return fabs(x); },
+      [](double acc, double x) { return acc + x; }, kColumns);
+  return sums.NormMax();
 }
 
 bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
@@ -108,6 +313,7 @@ bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
 
 void S21Matrix::SumMatrix(const S21Matrix& other) {
   if (rows_ != other.rows() || cols_ != other.columns()) throw ERROR_CALC;
+  detach();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       matrix_[i][j] += other(i, j);
@@ -117,12 +323,14 @@ void S21Matrix::SumMatrix(const S21Matrix& other) {
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
   if (rows_ != other.rows() || cols_ != other.columns()) throw ERROR_CALC;
+  detach();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) matrix_[i][j] -= other(i, j);
   }
 }
 
-void S21Matrix::MulNumber(const double num) noexcept {
+void S21Matrix::MulNumber(const double num) {
+  detach();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) matrix_[i][j] *= num;
   }
@@ -131,14 +339,8 @@ void S21Matrix::MulNumber(const double num) noexcept {
 void S21Matrix::MulMatrix(const S21Matrix& other) {
   if (cols_ != other.rows()) throw ERROR_CALC;
   S21Matrix result(rows_, other.columns());
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < other.columns(); j++) {
-      for (int k = 0; k < cols_; k++) {
-        result.matrix_[i][j] += other(k, j) * matrix_[i][k];
-      }
-    }
-  }
-  *this = result;
+  mulInto(*this, other, result);
+  *this = std::move(result);
 }
 
 S21Matrix S21Matrix::Transpose() const noexcept {
@@ -156,7 +358,7 @@ S21Matrix S21Matrix::CalcComplements() const {
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < rows_; j++) {
       minor = getMinor(i, j);
-      tmp = minor.Determinant();
+      tmp = minor.determinant();
       result.matrix_[i][j] = tmp * pow(-1.0, i + j);
     }
   }
@@ -166,61 +368,219 @@ S21Matrix S21Matrix::CalcComplements() const {
 double S21Matrix::Determinant() const {
   if (rows_ != cols_) throw ERROR_CALC;
   double result = 0.0;
-  S21Matrix minor;
-  if (rows_ == 1) result = matrix_[0][0];
-  if (rows_ == 2)
-    result = matrix_[0][0] * matrix_[1][1] - matrix_[1][0] * matrix_[0][1];
-  if (rows_ > 2) {
-    for (int i = 0; i < rows_; i++) {
-      minor = getMinor(i, 0);
-      result += minor.Determinant() * matrix_[i][0] * pow(-1.0, (double)(i));
+  Structure structure = DetectStructure();
+  if (rows_ > 0 && structure != kGeneral && structure != kBanded) {
+    result = 1.0;
+    for (int i = 0; i < rows_; i++) result *= matrix_[i][i];
+    return result;
+  }
+  bool cached = S21MatrixCache::Enabled();  // hashed once per call
+  uint64_t hash = cached ? S21MatrixCache::Hash(*this) : 0;
+  if (S21MatrixCache::FindDeterminant(*this, hash, &result)) return result;
+  result = determinant();
+  S21MatrixCache::StoreDeterminant(*this, hash, result);
+  return result;
+}
+
+double S21Matrix::determinant() const {
+  if (rows_ == 0) return 0.0;
+  if (rows_ == 1) return matrix_[0][0];
+  vector<double> lu(static_cast<size_t>(rows_) * rows_);
+  vector<int> piv(rows_);
+  packRows(matrix_, rows_, rows_, lu.data());
+  if (!luFactorTiled(lu.data(), rows_, piv.data())) return 0.0;
+  return luDeterminant(lu.data(), piv.data(), rows_);
+}
+
+S21Matrix S21Matrix::triangularInverse(Structure structure) const {
+  S21Matrix result(rows_, rows_);
+  for (int j = 0; j < rows_; j++) {  // solve column j of T * X = I
+    result.matrix_[j][j] = 1.0 / matrix_[j][j];
+    if (structure == kUpperTriangular) {
+      for (int i = j - 1; i >= 0; i--) {
+        double sum = 0.0;
+        for (int k = i + 1; k <= j; k++)
+          sum += matrix_[i][k] * result.matrix_[k][j];
+        result.matrix_[i][j] = -sum / matrix_[i][i];
+      }
+    } else if (structure == kLowerTriangular) {
+      for (int i = j + 1; i < rows_; i++) {
+        double sum = 0.0;
+        for (int k = j; k < i; k++) sum += matrix_[i][k] * result.matrix_[k][j];
+        result.matrix_[i][j] = -sum / matrix_[i][i];
+      }
     }
   }
   return result;
 }
 
 S21Matrix S21Matrix::InverseMatrix() const {
-  double det = this->Determinant();
-  if (fabs(det) < M_DIF) throw ERROR_CALC;
-  S21Matrix result(rows_, cols_);
-  if (rows_ == 1)
-    result(0, 0) = 1.0 / matrix_[0][0];
-  else {
-    result = CalcComplements();
-    result.MulNumber(1.0 / det);
-    result = result.Transpose();
+  S21Matrix result;
+  Structure structure = DetectStructure();
+  if (rows_ > 0 && rows_ == cols_ && structure != kGeneral &&
+      structure != kBanded) {
+    vector<double> diagonal(rows_);  // the pivots of a triangular matrix
+    for (int i = 0; i < rows_; i++) diagonal[i] = matrix_[i][i];
+    if (pivotsSingular(diagonal.data(), rows_, 1)) throw ERROR_CALC;
+    return triangularInverse(structure);
+  }
+  if (rows_ != cols_ || rows_ == 0) throw ERROR_CALC;
+  bool cached = S21MatrixCache::Enabled();  // hashed once per call
+  uint64_t hash = cached ? S21MatrixCache::Hash(*this) : 0;
+  if (S21MatrixCache::FindInverse(*this, hash, &result)) {
+    if (result.rows_ == 0) throw ERROR_CALC;  // cached as singular
+    return result;
   }
+  int n = rows_;
+  vector<double> lu(static_cast<size_t>(n) * n);
+  vector<int> piv(n);
+  packRows(matrix_, n, n, lu.data());
+  bool regular = luFactorTiled(lu.data(), n, piv.data());
+  double det = regular ? luDeterminant(lu.data(), piv.data(), n) : 0.0;
+  if (!regular || luSingular(lu.data(), n)) {
+    S21MatrixCache::StoreInverse(*this, hash, det, result);
+    throw ERROR_CALC;
+  }
+  result = S21Matrix(n, n);
+  const int width = 64;  // identity columns solved per task
+  S21Executor::Instance().ParallelFor(
+      (n + width - 1) / width, 1, [&](int begin, int end) {
+        vector<double> x;
+        for (int b = begin; b < end; b++) {
+          int col = b * width, w = min(width, n - col);
+          x.assign(static_cast<size_t>(n) * w, 0.0);
+          for (int c = 0; c < w; c++) x[(col + c) * w + c] = 1.0;
+          luSolve(lu.data(), piv.data(), n, x.data(), w);
+          for (int i = 0; i < n; i++)
+            copy(x.begin() + i * w, x.begin() + (i + 1) * w,
+                 result.matrix_[i] + col);
+        }
+      });
+  S21MatrixCache::StoreInverse(*this, hash, det, result);
   return result;
 }
 
+#define MIXED_MAX_REFINE 30
+// every refinement step costs a double residual of 2 * n^2 * nrhs flops, so
+// beyond n / MIXED_RHS_RATIO right-hand sides a double solve is cheaper
+#define MIXED_RHS_RATIO 32
+
+void S21Matrix::MulMatrixMixed(const S21Matrix& other) {
+  if (cols_ != other.rows()) throw ERROR_CALC;
+  int n = other.columns();
+  vector<float> a(static_cast<size_t>(rows_) * cols_),
+      b(static_cast<size_t>(cols_) * n);
+  packRows(matrix_, rows_, cols_, a.data());
+  packRows(other.matrix_, cols_, n, b.data());
+  S21Matrix result(rows_, n);
+  gemmMixed(rows_, n, cols_, a.data(), b.data(), result.matrix_);
+  *this = std::move(result);
+}
+
+bool S21Matrix::refineMixed(const S21Matrix& b, S21Matrix& x) const {
+  int n = rows_, nrhs = b.columns();
+  size_t size = static_cast<size_t>(n) * nrhs;
+  vector<float> lu(static_cast<size_t>(n) * n), d(size);
+  vector<int> piv(n);
+  packRows(matrix_, n, n, lu.data());
+  if (!luFactorTiled(lu.data(), n, piv.data()) || luSingular(lu.data(), n))
+    return false;
+  S21Matrix r(n, nrhs);
+  x = S21Matrix(n, nrhs);
+  packRows(b.matrix_, n, nrhs, d.data());
+  luSolveColumns(lu.data(), piv.data(), n, d.data(), nrhs);
+  for (int i = 0; i < n; i++)
+    copy(d.begin() + static_cast<size_t>(i) * nrhs,
+         d.begin() + static_cast<size_t>(i + 1) * nrhs, x.matrix_[i]);
+  double prev = HUGE_VAL;
+  for (int it = 0; it < MIXED_MAX_REFINE; it++) {
+    for (int i = 0; i < n; i++)
+      copy(b.matrix_[i], b.matrix_[i] + nrhs, r.matrix_[i]);
+    Gemm(-1.0, *this, x, 1.0, r);  // residual b - A*x in double
+    packRows(r.matrix_, n, nrhs, d.data());
+    luSolveColumns(lu.data(), piv.data(), n, d.data(), nrhs);
+    double dmax = 0.0, xmax = 1.0;
+    for (int i = 0; i < n; i++) {
+      double* xi = x.matrix_[i];
+      const float* di = d.data() + static_cast<size_t>(i) * nrhs;
+      for (int c = 0; c < nrhs; c++) {
+        xi[c] += di[c];
+        dmax = fmax(dmax, fabs(di[c]));
+        xmax = fmax(xmax, fabs(xi[c]));
+      }
+    }
+    if (dmax <= M_DIF * xmax) return true;
+    if (it > 1 && dmax > 0.5 * prev) return false;  // stagnation
+    prev = dmax;
+  }
+  return false;
+}
+
+S21Matrix S21Matrix::SolveMixed(const S21Matrix& b) const {
+  if (rows_ != cols_ || rows_ != b.rows()) throw ERROR_CALC;
+  int n = rows_, nrhs = b.columns();
+  S21Matrix x;
+  if (static_cast<long>(nrhs) * MIXED_RHS_RATIO <= n && refineMixed(b, x))
+    return x;
+  // many right-hand sides, float LU failed or too ill-conditioned: double
+  vector<double> lu(static_cast<size_t>(n) * n);
+  vector<double> rhs(static_cast<size_t>(n) * nrhs);
+  vector<int> piv(n);
+  packRows(matrix_, n, n, lu.data());
+  if (!luFactorTiled(lu.data(), n, piv.data()) || luSingular(lu.data(), n))
+    throw ERROR_CALC;
+  packRows(b.matrix_, n, nrhs, rhs.data());
+  luSolveColumns(lu.data(), piv.data(), n, rhs.data(), nrhs);
+  x = S21Matrix(n, nrhs);
+  for (int i = 0; i < n; i++)
+    copy(rhs.begin() + static_cast<size_t>(i) * nrhs,
+         rhs.begin() + static_cast<size_t>(i + 1) * nrhs, x.matrix_[i]);
+  return x;
+}
+
 S21Matrix S21Matrix::operator+(const S21Matrix& other) const {
-  S21Matrix tmp(*this);
-  tmp.SumMatrix(other);
-  return tmp;
+  if (rows_ != other.rows() || cols_ != other.columns()) throw ERROR_CALC;
+  S21Matrix result;
+  if (matrix_ == nullptr) return result;
+  result.allocate(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++)
+      result.matrix_[i][j] = matrix_[i][j] + other.matrix_[i][j];
+  }
+  return result;
 }
 
 S21Matrix S21Matrix::operator-(const S21Matrix& other) const {
-  S21Matrix tmp(*this);
-  tmp.SubMatrix(other);
-  return tmp;
+  if (rows_ != other.rows() || cols_ != other.columns()) throw ERROR_CALC;
+  S21Matrix result;
+  if (matrix_ == nullptr) return result;
+  result.allocate(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++)
+      result.matrix_[i][j] = matrix_[i][j] - other.matrix_[i][j];
+  }
+  return result;
 }
 
 S21Matrix S21Matrix::operator*(const S21Matrix& other) const {
-  S21Matrix tmp(*this);
-  tmp.MulMatrix(other);
-  return tmp;
+  if (cols_ != other.rows()) throw ERROR_CALC;
+  S21Matrix result(rows_, other.columns());
+  mulInto(*this, other, result);
+  return result;
 }
 
 S21Matrix S21Matrix::operator*(const double& num) const {
-  S21Matrix tmp(*this);
-  tmp.MulNumber(num);
-  return tmp;
+  S21Matrix result;
+  if (matrix_ == nullptr) return result;
+  result.allocate(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) result.matrix_[i][j] = matrix_[i][j] * num;
+  }
+  return result;
 }
 
 S21Matrix operator*(const double& num, const S21Matrix& other) {
-  S21Matrix tmp(other);
-  tmp.MulNumber(num);
-  return tmp;
+  return other * num;
 }
 
 bool S21Matrix::operator==(const S21Matrix& other) const noexcept {
@@ -229,21 +589,15 @@ bool S21Matrix::operator==(const S21Matrix& other) const noexcept {
 
 S21Matrix& S21Matrix::operator=(const S21Matrix& other) noexcept {
   if (this == &other) return *this;
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; i++)
-      if (matrix_[i] != nullptr) delete[] matrix_[i];
-    delete[] matrix_;
-  }
+  freeMatrix();
+  copyFrom(other);
+  return *this;
+}
 
-  cols_ = other.columns();
-  rows_ = other.rows();
-  matrix_ = new double*[rows_];
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_];
-  }
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) matrix_[i][j] = other(i, j);
-  }
+S21Matrix& S21Matrix::operator=(S21Matrix&& other) noexcept {
+  if (this == &other) return *this;
+  freeMatrix();
+  takeFrom(other);
   return *this;
 }
 
@@ -262,12 +616,19 @@ S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
   return *this;
 }
 
-S21Matrix& S21Matrix::operator*=(const double& num) noexcept {
+S21Matrix& S21Matrix::operator*=(const double& num) {
   MulNumber(num);
   return *this;
 }
 
-double& S21Matrix::operator()(int r, int c) const {
+double& S21Matrix::operator()(int r, int c) {
+  if (r >= rows_ || c >= cols_ || r < 0 || c < 0) throw ERROR_MATRIX;
+  detach();
+  unshareable_ = true;
+  return matrix_[r][c];
+}
+
+const double& S21Matrix::operator()(int r, int c) const {
   if (r >= rows_ || c >= cols_ || r < 0 || c < 0) throw ERROR_MATRIX;
   return matrix_[r][c];
 }
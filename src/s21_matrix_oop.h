@@ -1,8 +1,14 @@
 #ifndef SRC_S21_MATRIX_H_
 #define SRC_S21_MATRIX_H_
 
+#include <atomic>
 #include <cmath>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
+
+#include "s21_executor.h"
 
 #define SUCCESS 1
 #define FAILED 0
@@ -13,49 +19,351 @@
 
 using namespace std;
 
+class S21Matrix;
+
+// c = alpha * op(a) * op(b) + beta * c, where op(x) is x or x^T; c must
+// already have the result shape and is written in place without allocating
+void Gemm(double alpha, const S21Matrix& a, const S21Matrix& b, double beta,
+          S21Matrix& c, bool trans_a = false, bool trans_b = false);
+// y += alpha * x
+void Axpy(double alpha, const S21Matrix& x, S21Matrix& y);
+
 class S21Matrix {
+ public:
+  using Deleter = function<void(double*)>;
+  enum Structure {
+    kGeneral,
+    kDiagonal,
+    kUpperTriangular,
+    kLowerTriangular,
+    kBanded  // nonzeros within a band covering at most half the columns
+  };
+  enum Axis {
+    kAll,
+    kRows,    // one result per row: rows() x 1
+    kColumns  // one result per column: 1 x columns()
+  };
+
  private:
+  // Contiguous block counted by the matrices sharing it in COW mode; free
+  // is empty for borrowed buffers
+  struct Storage {
+    double* data;
+    Deleter free;
+    atomic<int> owners;
+    bool adopted;  // came from the buffer constructor, not from new[]
+    Storage(double* data, Deleter free, bool adopted = false);
+  };
+
   // Attributes
   int rows_;
   int cols_;
-  double** matrix_;  // Pointer to the memory where the matrix is allocated
+  int row_cap_;  // rows_/cols_ may grow up to these without reallocating
+  int col_cap_;
+  double** matrix_;  // Row pointers into storage_
+  Storage* storage_;
+  // a mutable reference or pointer into storage_ was handed out (or the
+  // buffer is adopted), so copies must not share it
+  bool unshareable_;
+  static atomic<bool> copy_on_write_;
   S21Matrix getMinor(int r_minor, int c_minor) const noexcept;
+  double determinant() const;  // uncached, through luFactorTiled
+  S21Matrix triangularInverse(Structure structure) const;
+  // x of A * x = b from a tiled float LU refined with double residuals;
+  // false when the float LU fails or refinement stalls short of M_DIF
+  bool refineMixed(const S21Matrix& b, S21Matrix& x) const;
+  void allocate(int rows, int cols);
+  void reallocate(int row_cap, int col_cap);
+  void freeMatrix() noexcept;
+  void dropStorage() noexcept;
+  void copyFrom(const S21Matrix& other);
+  void detach();  // takes a private copy of a shared buffer before writing
+  void takeFrom(S21Matrix& other) noexcept;  // moves, leaves other empty
+  static void mulInto(const S21Matrix& a, const S21Matrix& b,
+                      S21Matrix& result);
+  static void gemmKernel(double alpha, const S21Matrix& a, bool trans_a,
+                         const S21Matrix& b, bool trans_b,
+                         S21Matrix& c);  // c += alpha*op(a)*op(b)
+  friend class S21Inverse;
+  static const int kParallelElements = 1 << 16;
+  template <typename Body>
+  void forRowRanges(Body body) const;
+  // body(c, begin, end) for every block c of chunk rows, on S21Executor;
+  // c is stable however the pool groups the blocks
+  template <typename Body>
+  void forRowChunks(int chunk, Body body) const;
 
  public:
   S21Matrix();
   explicit S21Matrix(int rows, int cols);
   S21Matrix(const S21Matrix& other);
   S21Matrix(S21Matrix&& other) noexcept;
+  // wraps a row-major buffer without copying; ld is the row stride (0 means
+  // cols). Without a deleter the caller keeps ownership and the buffer must
+  // outlive the matrix and its copies; with one the matrix owns it.
+  S21Matrix(double* data, int rows, int cols, int ld = 0,
+            Deleter deleter = nullptr);
   ~S21Matrix();
 
   int rows() const noexcept;
   int columns() const noexcept;
   void setRows(int r);
   void setColumns(int c);
+  int capacityRows() const noexcept;
+  int capacityColumns() const noexcept;
+  void reserve(int rows, int cols);
+  void shrinkToFit();
+  void appendRow(const S21Matrix& row);  // 1 x columns()
+  void appendRow(const double* values, int count);
+
+  double* data();
+  const double* data() const noexcept;
+  int leadingDimension() const noexcept;
+  // gives up the buffer and leaves the matrix empty, storing its row stride
+  // in *ld. A buffer of our own is first compacted (and unshared) to
+  // rows() x columns(), so ld is columns() and it is freed with delete[]. An
+  // adopted buffer with a deleter comes back unchanged, laid out as it was
+  // passed in; a borrowed one (no deleter) throws ERROR_MATRIX.
+  double* release(int* ld = nullptr);
+
+  // copies share a reference-counted buffer until one of them is written.
+  // Once operator() or data() has handed out a mutable reference the matrix
+  // detaches and stays unshared, so the reference can never reach a copy;
+  // growing the storage invalidates such references as before.
+  static void SetCopyOnWrite(bool enabled) noexcept;
+  static bool CopyOnWrite() noexcept;
+  bool isShared() const noexcept;
+
+  // Widest distance below/above the diagonal of a nonzero; O(rows) for dense
+  // rows because each row is only scanned in from both ends
+  void Bandwidth(int* lower, int* upper) const noexcept;
+  Structure DetectStructure() const noexcept;
+
+  // Element-wise building blocks; f is inlined into the row loops and large
+  // matrices are split across S21Executor. reduce must be associative
+  // because chunks are folded separately and then combined. An exception
+  // thrown by a callback reaches the caller; the output is then unspecified.
+  template <typename F>
+  S21Matrix Map(F f) const;
+  template <typename F>
+  void Apply(F f);
+  template <typename F>
+  S21Matrix Zip(const S21Matrix& other, F f) const;
+  template <typename M, typename R>
+  double MapReduce(double init, M map, R reduce) const;
+  template <typename M, typename R>
+  S21Matrix MapReduce(double init, M map, R reduce, Axis axis) const;
+  template <typename R>
+  double Reduce(double init, R reduce) const;
+  template <typename R>
+  S21Matrix Reduce(double init, R reduce, Axis axis) const;
+
+  double Trace() const;
+  double NormFrobenius() const;
+  double NormMax() const;
+  double Norm1() const;  // largest absolute column sum
 
   bool EqMatrix(const S21Matrix& other) const noexcept;
   void SumMatrix(const S21Matrix& other);
   void SubMatrix(const S21Matrix& other);
-  void MulNumber(const double num) noexcept;
+  void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
   S21Matrix Transpose() const noexcept;
   S21Matrix CalcComplements() const;
   double Determinant() const;
   S21Matrix InverseMatrix() const;
+  // A^n by repeated squaring (powers of A^-1 for negative n); the squares
+  // and partial products ping-pong between three buffers
+  S21Matrix Pow(int n) const;
+  // c[0] * I + c[1] * A + c[2] * A^2 + ... by Paterson-Stockmeyer, about
+  // 2 * sqrt(degree) matrix products instead of degree for Horner
+  S21Matrix Polynomial(const vector<double>& coefficients) const;
+  // float operands, every product widened and summed in double
+  void MulMatrixMixed(const S21Matrix& other);
+  // tiled float LU refined to double accuracy with Gemm residuals; with more
+  // than n / 32 right-hand sides (an inverse, say) every refinement step
+  // costs more than the float factorization saves, so those solve in double
+  S21Matrix SolveMixed(const S21Matrix& b) const;
+
+  // scheduled on S21Executor, operands are copied into the task
+  S21Future<S21Matrix> SumMatrixAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> SubMatrixAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> MulNumberAsync(const double num) const;
+  S21Future<S21Matrix> MulMatrixAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> TransposeAsync() const;
+  S21Future<S21Matrix> CalcComplementsAsync() const;
+  S21Future<double> DeterminantAsync() const;
+  S21Future<S21Matrix> InverseMatrixAsync() const;
 
   S21Matrix operator+(const S21Matrix&) const;
   S21Matrix operator-(const S21Matrix&) const;
   S21Matrix operator*(const S21Matrix&) const;
   S21Matrix operator*(const double&) const;
   friend S21Matrix operator*(const double&, const S21Matrix&);
+  friend void Gemm(double alpha, const S21Matrix& a, const S21Matrix& b,
+                   double beta, S21Matrix& c, bool trans_a, bool trans_b);
+  friend void Axpy(double alpha, const S21Matrix& x, S21Matrix& y);
   bool operator==(const S21Matrix& other) const noexcept;
   S21Matrix& operator=(const S21Matrix&) noexcept;
+  S21Matrix& operator=(S21Matrix&&) noexcept;
   S21Matrix& operator+=(const S21Matrix&);
   S21Matrix& operator-=(const S21Matrix&);
   S21Matrix& operator*=(const S21Matrix&);
-  S21Matrix& operator*=(const double&) noexcept;
-  double& operator()(int r, int c) const;
+  S21Matrix& operator*=(const double&);
+  double& operator()(int r, int c);
+  const double& operator()(int r, int c) const;
 };
 S21Matrix operator*(const double&, const S21Matrix&);
+
+// product of the whole chain, parenthesized to minimize scalar multiplies
+S21Matrix MulChain(const vector<const S21Matrix*>& factors);
+S21Matrix MulChain(initializer_list<reference_wrapper<const S21Matrix>> chain);
+
+// dependency-chained variants: run once their input futures are done
+S21Future<S21Matrix> SumMatrixAsync(const S21Future<S21Matrix>&,
+                                    const S21Future<S21Matrix>&);
+S21Future<S21Matrix> SubMatrixAsync(const S21Future<S21Matrix>&,
+                                    const S21Future<S21Matrix>&);
+S21Future<S21Matrix> MulNumberAsync(const S21Future<S21Matrix>&, double);
+S21Future<S21Matrix> MulMatrixAsync(const S21Future<S21Matrix>&,
+                                    const S21Future<S21Matrix>&);
+S21Future<S21Matrix> TransposeAsync(const S21Future<S21Matrix>&);
+S21Future<S21Matrix> CalcComplementsAsync(const S21Future<S21Matrix>&);
+S21Future<double> DeterminantAsync(const S21Future<S21Matrix>&);
+S21Future<S21Matrix> InverseMatrixAsync(const S21Future<S21Matrix>&);
+
+template <typename Body>
+void S21Matrix::forRowRanges(Body body) const {
+  if (static_cast<long>(rows_) * cols_ < kParallelElements)
+    return body(0, rows_);
+  S21Executor::Instance().ParallelFor(
+      rows_, max(1, kParallelElements / max(cols_, 1)), body);
+}
+
+template <typename Body>
+void S21Matrix::forRowChunks(int chunk, Body body) const {
+  int chunks = (rows_ + chunk - 1) / chunk;
+  auto run = [&](int begin, int end) {
+    for (int c = begin; c < end; c++)
+      body(c, c * chunk, min(rows_, (c + 1) * chunk));
+  };
+  if (chunks == 1) return run(0, 1);
+  S21Executor::Instance().ParallelFor(chunks, 1, run);
+}
+
+template <typename F>
+S21Matrix S21Matrix::Map(F f) const {
+  S21Matrix result;
+  if (matrix_ == nullptr) return result;
+  result.allocate(rows_, cols_);
+  forRowRanges([&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const double* src = matrix_[i];
+      double* dst = result.matrix_[i];
+      for (int j = 0; j < cols_; j++) dst[j] = f(src[j]);
+    }
+  });
+  return result;
+}
+
+template <typename F>
+void S21Matrix::Apply(F f) {
+  detach();
+  forRowRanges([&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = matrix_[i];
+      for (int j = 0; j < cols_; j++) row[j] = f(row[j]);
+    }
+  });
+}
+
+template <typename F>
+S21Matrix S21Matrix::Zip(const S21Matrix& other, F f) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) throw ERROR_CALC;
+  S21Matrix result;
+  if (matrix_ == nullptr) return result;
+  result.allocate(rows_, cols_);
+  forRowRanges([&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const double* x = matrix_[i];
+      const double* y = other.matrix_[i];
+      double* dst = result.matrix_[i];
+      for (int j = 0; j < cols_; j++) dst[j] = f(x[j], y[j]);
+    }
+  });
+  return result;
+}
+
+template <typename M, typename R>
+double S21Matrix::MapReduce(double init, M map, R reduce) const {
+  if (matrix_ == nullptr) return init;
+  int chunk = max(1, kParallelElements / cols_);
+  vector<double> partial((rows_ + chunk - 1) / chunk);
+  forRowChunks(chunk, [&](int c, int begin, int end) {
+    double acc = map(matrix_[begin][0]);
+    for (int i = begin; i < end; i++) {
+      const double* row = matrix_[i];
+      for (int j = i == begin ? 1 : 0; j < cols_; j++)
+        acc = reduce(acc, map(row[j]));
+    }
+    partial[c] = acc;
+  });
+  for (double value : partial) init = reduce(init, value);
+  return init;
+}
+
+template <typename M, typename R>
+S21Matrix S21Matrix::MapReduce(double init, M map, R reduce,
+                               Axis axis) const {
+  if (axis == kAll) {
+    S21Matrix result(1, 1);
+    result.matrix_[0][0] = MapReduce(init, map, reduce);
+    return result;
+  }
+  if (matrix_ == nullptr) throw ERROR_MATRIX;
+  if (axis == kRows) {
+    S21Matrix result(rows_, 1);
+    forRowRanges([&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        const double* row = matrix_[i];
+        double acc = init;
+        for (int j = 0; j < cols_; j++) acc = reduce(acc, map(row[j]));
+        result.matrix_[i][0] = acc;
+      }
+    });
+    return result;
+  }
+  // row by row, so the inner loop is contiguous; one partial row per chunk
+  int chunk = max(1, kParallelElements / cols_);
+  int chunks = (rows_ + chunk - 1) / chunk;
+  vector<double> partial(static_cast<size_t>(chunks) * cols_);
+  forRowChunks(chunk, [&](int c, int begin, int end) {
+    double* acc = partial.data() + static_cast<size_t>(c) * cols_;
+    for (int j = 0; j < cols_; j++) acc[j] = map(matrix_[begin][j]);
+    for (int i = begin + 1; i < end; i++) {
+      const double* row = matrix_[i];
+      for (int j = 0; j < cols_; j++) acc[j] = reduce(acc[j], map(row[j]));
+    }
+  });
+  S21Matrix result(1, cols_);
+  double* out = result.matrix_[0];
+  fill(out, out + cols_, init);
+  for (int c = 0; c < chunks; c++) {
+    const double* acc = partial.data() + static_cast<size_t>(c) * cols_;
+    for (int j = 0; j < cols_; j++) out[j] = reduce(out[j], acc[j]);
+  }
+  return result;
+}
+
+template <typename R>
+double S21Matrix::Reduce(double init, R reduce) const {
+  return MapReduce(init, [](double x) { return x; }, reduce);
+}
+
+template <typename R>
+S21Matrix S21Matrix::Reduce(double init, R reduce, Axis axis) const {
+  return MapReduce(init, [](double x) { return x; }, reduce, axis);
+}
+
 // void print_matrix(const S21Matrix&);
 #endif  // SRC_S21_MATRIX_H_
@@ -0,0 +1,378 @@
+#include "s21_matrix_packed.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+S21PackedMatrix::S21PackedMatrix(int size, Kind kind, Triangle triangle,
+                                 bool tiled)
+    : size_(size), kind_(kind), triangle_(triangle), tiled_(tiled) {
+  if (size <= 0) throw ERROR_MATRIX;
+  size_t count = tiled ? static_cast<size_t>(tiles()) * (tiles() + 1) / 2 *
+                             kTile * kTile
+                       : static_cast<size_t>(size) * (size + 1) / 2;
+  data_.assign(count, 0.0);
+}
+
+S21PackedMatrix::S21PackedMatrix(const S21Matrix& matrix, Kind kind,
+                                 Triangle triangle, bool tiled)
+    : S21PackedMatrix(matrix.rows(), kind, triangle, tiled) {
+  if (matrix.columns() != size_) throw ERROR_CALC;
+  forEachRun(false, [&](int i, int begin, int end, size_t offset) {
+    for (int j = begin; j < end; j++) data_[offset + j - begin] = matrix(i, j);
+  });
+}
+
+int S21PackedMatrix::size() const noexcept { return size_; }
+
+S21PackedMatrix::Kind S21PackedMatrix::kind() const noexcept { return kind_; }
+
+S21PackedMatrix::Triangle S21PackedMatrix::triangle() const noexcept {
+  return triangle_;
+}
+
+bool S21PackedMatrix::tiled() const noexcept { return tiled_; }
+
+size_t S21PackedMatrix::storageSize() const noexcept { return data_.size(); }
+
+int S21PackedMatrix::tiles() const noexcept {
+  return (size_ + kTile - 1) / kTile;
+}
+
+size_t S21PackedMatrix::tileOffset(int tile_row, int tile_col) const noexcept {
+  size_t r = tile_row, c = tile_col, t = tiles();
+  size_t tile = triangle_ == kLower ? r * (r + 1) / 2 + c
+                                    : r * (2 * t - r + 1) / 2 + (c - r);
+  return tile * kTile * kTile;
+}
+
+bool S21PackedMatrix::stored(int i, int j) const noexcept {
+  return triangle_ == kLower ? j <= i : j >= i;
+}
+
+size_t S21PackedMatrix::index(int i, int j) const noexcept {
+  if (tiled_)
+    return tileOffset(i / kTile, j / kTile) + (i % kTile) * kTile + j % kTile;
+  size_t r = i, n = size_;
+  return triangle_ == kLower ? r * (r + 1) / 2 + j
+                             : r * (2 * n - r + 1) / 2 + (j - r);
+}
+
+template <typename F>
+void S21PackedMatrix::forEachRun(bool reverse, F f) const {
+  bool lower = triangle_ == kLower;
+  if (!tiled_) {
+    for (int s = 0; s < size_; s++) {
+      int i = reverse ? size_ - 1 - s : s;
+      int begin = lower ? 0 : i, end = lower ? i + 1 : size_;
+      f(i, begin, end, index(i, begin));
+    }
+    return;
+  }
+  int t = tiles();
+  for (int a = 0; a < t; a++) {
+    int tile_row = reverse ? t - 1 - a : a;
+    int first = lower ? 0 : tile_row, last = lower ? tile_row : t - 1;
+    int rows = min(kTile, size_ - tile_row * kTile);
+    for (int b = first; b <= last; b++) {
+      int tile_col = reverse ? first + last - b : b;
+      size_t offset = tileOffset(tile_row, tile_col);
+      for (int c = 0; c < rows; c++) {
+        int r = reverse ? rows - 1 - c : c;
+        int i = tile_row * kTile + r;
+        int begin = tile_col * kTile, end = min(size_, begin + kTile);
+        if (tile_col == tile_row) {
+          if (lower)
+            end = i + 1;
+          else
+            begin = i;
+        }
+        f(i, begin, end, offset + r * kTile + begin - tile_col * kTile);
+      }
+    }
+  }
+}
+
+double& S21PackedMatrix::operator()(int i, int j) {
+  if (i < 0 || j < 0 || i >= size_ || j >= size_) throw ERROR_MATRIX;
+  if (!stored(i, j)) {
+    if (kind_ == kTriangular) throw ERROR_MATRIX;
+    swap(i, j);
+  }
+  return data_[index(i, j)];
+}
+
+const double& S21PackedMatrix::operator()(int i, int j) const {
+  static const double zero = 0.0;
+  if (i < 0 || j < 0 || i >= size_ || j >= size_) throw ERROR_MATRIX;
+  if (!stored(i, j)) {
+    if (kind_ == kTriangular) return zero;
+    swap(i, j);
+  }
+  return data_[index(i, j)];
+}
+
+S21Matrix S21PackedMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  forEachRun(false, [&](int i, int begin, int end, size_t offset) {
+    for (int j = begin; j < end; j++) {
+      result(i, j) = data_[offset + j - begin];
+      if (kind_ == kSymmetric) result(j, i) = data_[offset + j - begin];
+    }
+  });
+  return result;
+}
+
+S21PackedMatrix S21PackedMatrix::lowerCopy() const {
+  S21PackedMatrix result(size_, kTriangular, kLower);
+  double* l = result.data_.data();
+  forEachRun(false, [&](int i, int begin, int end, size_t offset) {
+    for (int j = begin; j < end; j++)
+      l[result.index(max(i, j), min(i, j))] = data_[offset + j - begin];
+  });
+  return result;
+}
+
+S21Matrix S21PackedMatrix::operator*(const S21Matrix& other) const {
+  if (other.rows() != size_) throw ERROR_CALC;
+  int k = other.columns(), ldx = other.leadingDimension();
+  S21Matrix result(size_, k);
+  double* y = result.data();
+  int ldy = result.leadingDimension();
+  const double* x = other.data();
+  bool mirror = kind_ == kSymmetric;
+  forEachRun(false, [&](int i, int begin, int end, size_t offset) {
+    const double* a = data_.data() + offset;
+    double* yi = y + static_cast<size_t>(i) * ldy;
+    const double* xi = x + static_cast<size_t>(i) * ldx;
+    for (int j = begin; j < end; j++) {
+      double aij = a[j - begin];
+      const double* xj = x + static_cast<size_t>(j) * ldx;
+      for (int c = 0; c < k; c++) yi[c] += aij * xj[c];
+      if (!mirror || j == i) continue;
+      double* yj = y + static_cast<size_t>(j) * ldy;
+      for (int c = 0; c < k; c++) yj[c] += aij * xi[c];
+    }
+  });
+  return result;
+}
+
+void S21PackedMatrix::substitute(S21Matrix& x) const {
+  int k = x.columns(), ld = x.leadingDimension();
+  double* data = x.data();
+  forEachRun(triangle_ == kUpper,
+             [&](int i, int begin, int end, size_t offset) {
+               const double* a = data_.data() + offset;
+               double* xi = data + static_cast<size_t>(i) * ld;
+               for (int j = begin; j < end; j++) {
+                 if (j == i) continue;
+                 const double* xj = data + static_cast<size_t>(j) * ld;
+                 for (int c = 0; c < k; c++) xi[c] -= a[j - begin] * xj[c];
+               }
+               if (i < begin || i >= end) return;
+               if (a[i - begin] == 0.0) throw ERROR_CALC;
+               double inv = 1.0 / a[i - begin];
+               for (int c = 0; c < k; c++) xi[c] *= inv;
+             });
+}
+
+bool S21PackedMatrix::cholesky(S21PackedMatrix& factor) const {
+  factor = lowerCopy();
+  double* l = factor.data_.data();
+  for (int i = 0; i < size_; i++) {  // row by row, rows are contiguous
+    double* li = l + static_cast<size_t>(i) * (i + 1) / 2;
+    for (int j = 0; j <= i; j++) {
+      const double* lj = l + static_cast<size_t>(j) * (j + 1) / 2;
+      double sum = li[j];
+      for (int p = 0; p < j; p++) sum -= li[p] * lj[p];
+      if (j < i) {
+        li[j] = sum / lj[j];
+      } else {
+        if (sum <= 0.0) return false;
+        li[i] = sqrt(sum);
+      }
+    }
+  }
+  return true;
+}
+
+// Bunch-Kaufman as in LAPACK dsptrf: P * A * P^T = L * D * L^T with D made
+// of 1x1 and 2x2 blocks. The interchanges are not applied to the columns of
+// L already computed, so ldltSolve replays them step by step.
+bool S21PackedMatrix::ldlt(S21PackedMatrix& factor, vector<int>& piv) const {
+  const double alpha = (1.0 + sqrt(17.0)) / 8.0;  // bounds element growth
+  factor = lowerCopy();
+  double* l = factor.data_.data();
+  auto at = [l](int i, int j) -> double& {  // i >= j
+    return l[static_cast<size_t>(i) * (i + 1) / 2 + j];
+  };
+  piv.assign(size_, 0);
+  vector<double> w0(size_), w1(size_);
+  for (int k = 0; k < size_;) {
+    double absakk = fabs(at(k, k)), colmax = 0.0;
+    int imax = k;
+    for (int i = k + 1; i < size_; i++)
+      if (fabs(at(i, k)) > colmax) colmax = fabs(at(i, k)), imax = i;
+    if (max(absakk, colmax) == 0.0) return false;
+    int kp = k, step = 1;
+    if (absakk < alpha * colmax) {
+      double rowmax = 0.0;  // largest off-diagonal of row/column imax
+      for (int j = k; j < imax; j++) rowmax = max(rowmax, fabs(at(imax, j)));
+      for (int i = imax + 1; i < size_; i++)
+        rowmax = max(rowmax, fabs(at(i, imax)));
+      if (absakk * rowmax < alpha * colmax * colmax) {
+        kp = imax;
+        if (fabs(at(imax, imax)) < alpha * rowmax) step = 2;
+      }
+    }
+    int kk = k + step - 1;
+    if (kp != kk) {  // symmetric interchange inside the trailing matrix
+      for (int i = kp + 1; i < size_; i++) swap(at(i, kk), at(i, kp));
+      for (int j = kk + 1; j < kp; j++) swap(at(j, kk), at(kp, j));
+      swap(at(kk, kk), at(kp, kp));
+      if (step == 2) swap(at(k + 1, k), at(kp, k));
+    }
+    if (step == 1) {
+      double r = 1.0 / at(k, k);
+      for (int i = k + 1; i < size_; i++) w0[i] = at(i, k);
+      for (int i = k + 1; i < size_; i++) {
+        double* li = &at(i, 0);
+        double f = r * w0[i];
+        for (int j = k + 1; j <= i; j++) li[j] -= f * w0[j];
+        li[k] = f;
+      }
+      piv[k] = kp;
+    } else {
+      double d21 = at(k + 1, k);
+      double d11 = at(k + 1, k + 1) / d21, d22 = at(k, k) / d21;
+      d21 = 1.0 / (d11 * d22 - 1.0) / d21;
+      for (int i = k + 2; i < size_; i++) {
+        w0[i] = d21 * (d11 * at(i, k) - at(i, k + 1));
+        w1[i] = d21 * (d22 * at(i, k + 1) - at(i, k));
+      }
+      for (int i = k + 2; i < size_; i++) {
+        double* li = &at(i, 0);
+        double a0 = li[k], a1 = li[k + 1];
+        for (int j = k + 2; j <= i; j++) li[j] -= a0 * w0[j] + a1 * w1[j];
+        li[k] = w0[i];
+        li[k + 1] = w1[i];
+      }
+      piv[k] = piv[k + 1] = -(kp + 1);  // negative marks a 2x2 block
+    }
+    k += step;
+  }
+  return true;
+}
+
+void S21PackedMatrix::ldltSolve(const vector<int>& piv, S21Matrix& x) const {
+  int k = x.columns(), ld = x.leadingDimension();
+  double* data = x.data();
+  const double* l = data_.data();
+  auto row = [data, ld](int i) { return data + static_cast<size_t>(i) * ld; };
+  auto lcol = [l](int i, int j) {  // L(i, j), i > j
+    return l[static_cast<size_t>(i) * (i + 1) / 2 + j];
+  };
+  auto swapRows = [&](int a, int b) {
+    if (a != b) swap_ranges(row(a), row(a) + k, row(b));
+  };
+  for (int p = 0; p < size_;) {  // L * D * y = P * b
+    if (piv[p] >= 0) {
+      swapRows(p, piv[p]);
+      double* xp = row(p);
+      for (int i = p + 1; i < size_; i++) {
+        double lip = lcol(i, p);
+        double* xi = row(i);
+        for (int c = 0; c < k; c++) xi[c] -= lip * xp[c];
+      }
+      double inv = 1.0 / lcol(p, p);
+      for (int c = 0; c < k; c++) xp[c] *= inv;
+      p++;
+      continue;
+    }
+    swapRows(p + 1, -piv[p] - 1);
+    double *x0 = row(p), *x1 = row(p + 1);
+    for (int i = p + 2; i < size_; i++) {
+      double l0 = lcol(i, p), l1 = lcol(i, p + 1);
+      double* xi = row(i);
+      for (int c = 0; c < k; c++) xi[c] -= l0 * x0[c] + l1 * x1[c];
+    }
+    double d21 = lcol(p + 1, p);
+    double d11 = lcol(p, p) / d21, d22 = lcol(p + 1, p + 1) / d21;
+    double denom = d11 * d22 - 1.0;
+    for (int c = 0; c < k; c++) {
+      double b0 = x0[c] / d21, b1 = x1[c] / d21;
+      x0[c] = (d22 * b0 - b1) / denom;
+      x1[c] = (d11 * b1 - b0) / denom;
+    }
+    p += 2;
+  }
+  for (int p = size_ - 1; p >= 0;) {  // L^T * P * x = y
+    int step = piv[p] >= 0 ? 1 : 2;
+    for (int q = p; q > p - step; q--) {
+      double* xq = row(q);
+      for (int i = p + 1; i < size_; i++) {
+        double liq = lcol(i, q);
+        const double* xi = row(i);
+        for (int c = 0; c < k; c++) xq[c] -= liq * xi[c];
+      }
+    }
+    swapRows(p, step == 1 ? piv[p] : -piv[p] - 1);
+    p -= step;
+  }
+}
+
+S21Matrix S21PackedMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows() != size_) throw ERROR_CALC;
+  S21Matrix x(b);
+  if (kind_ == kTriangular) {
+    substitute(x);
+    return x;
+  }
+  int k = x.columns(), ld = x.leadingDimension();
+  S21PackedMatrix factor(1, kTriangular);
+  if (cholesky(factor)) {  // L * L^T * x = b
+    factor.substitute(x);
+    double* data = x.data();
+    const double* l = factor.data_.data();
+    for (int i = size_ - 1; i >= 0; i--) {
+      const double* li = l + static_cast<size_t>(i) * (i + 1) / 2;
+      double* xi = data + static_cast<size_t>(i) * ld;
+      for (int c = 0; c < k; c++) xi[c] /= li[i];
+      for (int p = 0; p < i; p++) {
+        double* xp = data + static_cast<size_t>(p) * ld;
+        for (int c = 0; c < k; c++) xp[c] -= li[p] * xi[c];
+      }
+    }
+    return x;
+  }
+  vector<int> piv;
+  if (!ldlt(factor, piv)) throw ERROR_CALC;
+  factor.ldltSolve(piv, x);
+  return x;
+}
+
+double S21PackedMatrix::Determinant() const {
+  double det = 1.0;
+  if (kind_ == kTriangular) {
+    for (int i = 0; i < size_; i++) det *= data_[index(i, i)];
+    return det;
+  }
+  S21PackedMatrix factor(1, kTriangular);
+  if (cholesky(factor)) {
+    for (int i = 0; i < size_; i++) det *= factor(i, i) * factor(i, i);
+    return det;
+  }
+  vector<int> piv;
+  if (!ldlt(factor, piv)) return 0.0;
+  for (int k = 0; k < size_; k++) {  // P A P^T has the same determinant
+    if (piv[k] >= 0) {
+      det *= factor(k, k);
+    } else {
+      det *= factor(k, k) * factor(k + 1, k + 1) -
+             factor(k + 1, k) * factor(k + 1, k);
+      k++;
+    }
+  }
+  return det;
+}
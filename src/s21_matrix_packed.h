@@ -0,0 +1,70 @@
+#ifndef SRC_S21_MATRIX_PACKED_H_
+#define SRC_S21_MATRIX_PACKED_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// n x n symmetric or triangular matrix keeping only one triangle. Packed
+// storage lays the triangle out row by row in n * (n + 1) / 2 doubles; the
+// tiled variant stores it as kTile x kTile row-major tiles so multiply and
+// solve sweep cache-sized blocks, at the cost of padding the edge tiles.
+class S21PackedMatrix {
+ public:
+  enum Kind { kSymmetric, kTriangular };
+  enum Triangle { kLower, kUpper };
+
+ private:
+  int size_;
+  Kind kind_;
+  Triangle triangle_;
+  bool tiled_;
+  vector<double> data_;
+  static constexpr int kTile = 64;
+  int tiles() const noexcept;
+  size_t tileOffset(int tile_row, int tile_col) const noexcept;
+  bool stored(int i, int j) const noexcept;
+  size_t index(int i, int j) const noexcept;  // (i, j) in the stored half
+  // f(i, begin, end, offset) for every contiguous run [begin, end) of row i,
+  // in storage order or backwards. Walking towards the diagonal (lower
+  // forwards, upper backwards) a row's diagonal run comes last and every row
+  // it depends on is already finished, which is what substitution needs.
+  template <typename F>
+  void forEachRun(bool reverse, F f) const;
+  void substitute(S21Matrix& x) const;           // triangular, in place
+  S21PackedMatrix lowerCopy() const;  // the lower half, plain packed
+  bool cholesky(S21PackedMatrix& factor) const;  // lower, plain packed
+  // Bunch-Kaufman L * D * L^T of an indefinite matrix, lower, plain packed;
+  // piv[k] < 0 marks the rows k and k + 1 of a 2x2 block of D
+  bool ldlt(S21PackedMatrix& factor, vector<int>& piv) const;
+  void ldltSolve(const vector<int>& piv, S21Matrix& x) const;  // in place
+
+ public:
+  S21PackedMatrix(int size, Kind kind, Triangle triangle = kLower,
+                  bool tiled = false);
+  // keeps the given triangle of a square matrix and ignores the other one
+  S21PackedMatrix(const S21Matrix& matrix, Kind kind,
+                  Triangle triangle = kLower, bool tiled = false);
+
+  int size() const noexcept;
+  Kind kind() const noexcept;
+  Triangle triangle() const noexcept;
+  bool tiled() const noexcept;
+  size_t storageSize() const noexcept;  // doubles actually allocated
+
+  // a symmetric matrix maps (i, j) onto the stored half; writing the zero
+  // half of a triangular one throws ERROR_MATRIX
+  double& operator()(int i, int j);
+  const double& operator()(int i, int j) const;
+
+  S21Matrix ToMatrix() const;
+  S21Matrix operator*(const S21Matrix& other) const;  // n x k
+  // x with A * x = b (n x k). Triangular matrices substitute in place,
+  // symmetric ones use Cholesky and fall back to a pivoted L * D * L^T in
+  // packed storage when A is not positive definite; a singular A throws
+  // ERROR_CALC.
+  S21Matrix Solve(const S21Matrix& b) const;
+  double Determinant() const;
+};
+
+#endif  // SRC_S21_MATRIX_PACKED_H_
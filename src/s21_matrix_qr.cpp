@@ -0,0 +1,199 @@
+#include "s21_matrix_qr.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Turns rows k.. of column k into beta * e_1 with H = I - tau * v * v^T,
+// v_0 = 1 implicit; beta goes on the diagonal and v below it
+static double makeReflector(double* a, int ld, int m, int k) {
+  double alpha = a[k * ld + k], norm2 = 0.0;
+  for (int i = k + 1; i < m; i++) norm2 += a[i * ld + k] * a[i * ld + k];
+  if (norm2 == 0.0) return 0.0;
+  double beta = -copysign(sqrt(alpha * alpha + norm2), alpha);
+  double scale = 1.0 / (alpha - beta);
+  for (int i = k + 1; i < m; i++) a[i * ld + k] *= scale;
+  a[k * ld + k] = beta;
+  return (beta - alpha) / beta;
+}
+
+// Applies H_k to columns [begin, end) of rows k.. in two row-wise passes
+static void applyReflector(double* a, int ld, int m, int k, int begin,
+                           int end, double tau, vector<double>& w) {
+  if (tau == 0.0 || begin >= end) return;
+  fill(w.begin() + begin, w.begin() + end, 0.0);
+  for (int i = k; i < m; i++) {
+    double vi = i == k ? 1.0 : a[i * ld + k];
+    for (int j = begin; j < end; j++) w[j] += vi * a[i * ld + j];
+  }
+  for (int i = k; i < m; i++) {
+    double s = tau * (i == k ? 1.0 : a[i * ld + k]);
+    for (int j = begin; j < end; j++) a[i * ld + j] -= s * w[j];
+  }
+}
+
+// c = (I - V * op(T) * V^T) * c, op(T) = T^T when applying Q^T
+static void applyBlock(const S21Matrix& v, const S21Matrix& t, S21Matrix& c,
+                       bool transpose) {
+  S21Matrix w(v.columns(), c.columns()), tw(v.columns(), c.columns());
+  Gemm(1.0, v, c, 0.0, w, true);
+  Gemm(1.0, t, w, 0.0, tw, transpose);
+  Gemm(-1.0, v, tw, 1.0, c);
+}
+
+S21QR::S21QR(const S21Matrix& matrix, bool pivoting)
+    : qr_(matrix), rank_(0), pivoting_(pivoting) {
+  int m = qr_.rows(), n = qr_.columns();
+  if (m == 0 || n == 0) throw ERROR_CALC;
+  tau_.assign(min(m, n), 0.0);
+  perm_.resize(n);
+  for (int j = 0; j < n; j++) perm_[j] = j;
+  if (pivoting)
+    factorPivoted();
+  else
+    factorBlocked();
+  const double* a = qr_.data();
+  int ld = qr_.leadingDimension();
+  double largest = 0.0;
+  for (int k = 0; k < min(m, n); k++)
+    largest = max(largest, fabs(a[k * ld + k]));
+  for (int k = 0; k < min(m, n); k++)
+    if (fabs(a[k * ld + k]) > M_DIF * largest) rank_++;
+}
+
+void S21QR::factorBlocked() {
+  int m = qr_.rows(), n = qr_.columns(), p = min(m, n);
+  double* a = qr_.data();
+  int ld = qr_.leadingDimension();
+  vector<double> w(n);
+  for (int k = 0; k < p; k += kBlock) {
+    int kb = min(kBlock, p - k);
+    for (int j = k; j < k + kb; j++) {  // unblocked panel
+      tau_[j] = makeReflector(a, ld, m, j);
+      applyReflector(a, ld, m, j, j + 1, k + kb, tau_[j], w);
+    }
+    if (k + kb >= n) continue;
+    S21Matrix v, t;
+    blockReflector(k, kb, v, t);
+    S21Matrix trailing(a + k * ld + k + kb, m - k, n - k - kb, ld);
+    applyBlock(v, t, trailing, true);
+  }
+}
+
+void S21QR::factorPivoted() {
+  int m = qr_.rows(), n = qr_.columns(), p = min(m, n);
+  double* a = qr_.data();
+  int ld = qr_.leadingDimension();
+  vector<double> norms(n, 0.0), reference(n), w(n);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++) norms[j] += a[i * ld + j] * a[i * ld + j];
+  for (int j = 0; j < n; j++) reference[j] = norms[j] = sqrt(norms[j]);
+  for (int k = 0; k < p; k++) {
+    int best = max_element(norms.begin() + k, norms.end()) - norms.begin();
+    if (best != k) {
+      for (int i = 0; i < m; i++) swap(a[i * ld + k], a[i * ld + best]);
+      swap(norms[k], norms[best]);
+      swap(reference[k], reference[best]);
+      swap(perm_[k], perm_[best]);
+    }
+    tau_[k] = makeReflector(a, ld, m, k);
+    applyReflector(a, ld, m, k, k + 1, n, tau_[k], w);
+    for (int j = k + 1; j < n; j++) {  // downdate, recompute once inaccurate
+      if (norms[j] == 0.0) continue;
+      double ratio = fabs(a[k * ld + j]) / norms[j];
+      double rest = max(0.0, 1.0 - ratio * ratio);
+      double shrink = norms[j] / reference[j];
+      double drift = rest * shrink * shrink;
+      if (drift > sqrt(M_DIF)) {
+        norms[j] *= sqrt(rest);
+        continue;
+      }
+      double norm2 = 0.0;
+      for (int i = k + 1; i < m; i++) norm2 += a[i * ld + j] * a[i * ld + j];
+      reference[j] = norms[j] = sqrt(norm2);
+    }
+  }
+}
+
+void S21QR::blockReflector(int k, int kb, S21Matrix& v, S21Matrix& t) const {
+  int m = qr_.rows();
+  const double* a = qr_.data();
+  int ld = qr_.leadingDimension();
+  v = S21Matrix(m - k, kb);
+  for (int i = 0; i < m - k; i++) {
+    for (int j = 0; j < kb && j <= i; j++)
+      v(i, j) = i == j ? 1.0 : a[(k + i) * ld + k + j];
+  }
+  S21Matrix gram(kb, kb);  // V^T * V
+  Gemm(1.0, v, v, 0.0, gram, true);
+  t = S21Matrix(kb, kb);
+  vector<double> z(kb);
+  for (int j = 0; j < kb; j++) {  // T(0:j, j) = -tau_j * T(0:j, 0:j) * z
+    double tau = tau_[k + j];
+    for (int i = 0; i < j; i++) z[i] = -tau * gram(i, j);
+    for (int i = 0; i < j; i++) {
+      double sum = 0.0;
+      for (int l = i; l < j; l++) sum += t(i, l) * z[l];
+      t(i, j) = sum;
+    }
+    t(j, j) = tau;
+  }
+}
+
+S21Matrix S21QR::Q() const {
+  int m = qr_.rows(), p = min(m, qr_.columns());
+  S21Matrix q(m, p);
+  for (int i = 0; i < p; i++) q(i, i) = 1.0;
+  double* data = q.data();
+  int ld = q.leadingDimension();
+  for (int k = (p - 1) / kBlock * kBlock; k >= 0; k -= kBlock) {
+    int kb = min(kBlock, p - k);
+    S21Matrix v, t;
+    blockReflector(k, kb, v, t);
+    S21Matrix block(data + k * ld + k, m - k, p - k, ld);
+    applyBlock(v, t, block, false);
+  }
+  return q;
+}
+
+S21Matrix S21QR::R() const {
+  int p = min(qr_.rows(), qr_.columns()), n = qr_.columns();
+  S21Matrix r(p, n);
+  for (int i = 0; i < p; i++)
+    for (int j = i; j < n; j++) r(i, j) = qr_(i, j);
+  return r;
+}
+
+const vector<int>& S21QR::Permutation() const noexcept { return perm_; }
+
+int S21QR::Rank() const noexcept { return rank_; }
+
+S21Matrix S21QR::LeastSquares(const S21Matrix& b) const {
+  int m = qr_.rows(), n = qr_.columns(), p = min(m, n), nrhs = b.columns();
+  if (b.rows() != m) throw ERROR_CALC;
+  if (!pivoting_ && rank_ < n) throw ERROR_CALC;
+  S21Matrix y(b);
+  double* data = y.data();
+  int ld = y.leadingDimension();
+  for (int k = 0; k < p; k += kBlock) {  // y = Q^T * b
+    int kb = min(kBlock, p - k);
+    S21Matrix v, t;
+    blockReflector(k, kb, v, t);
+    S21Matrix rows(data + k * ld, m - k, nrhs, ld);
+    applyBlock(v, t, rows, true);
+  }
+  S21Matrix x(n, nrhs);
+  const double* a = qr_.data();
+  int lda = qr_.leadingDimension();
+  for (int i = rank_ - 1; i >= 0; i--) {  // R(0:r, 0:r) * x = y(0:r)
+    double* xi = &x(perm_[i], 0);
+    for (int c = 0; c < nrhs; c++) xi[c] = y(i, c);
+    for (int l = i + 1; l < rank_; l++) {
+      double r = a[i * lda + l];
+      const double* xl = &x(perm_[l], 0);
+      for (int c = 0; c < nrhs; c++) xi[c] -= r * xl[c];
+    }
+    for (int c = 0; c < nrhs; c++) xi[c] /= a[i * lda + i];
+  }
+  return x;
+}
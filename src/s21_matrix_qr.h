@@ -0,0 +1,41 @@
+#ifndef SRC_S21_MATRIX_QR_H_
+#define SRC_S21_MATRIX_QR_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Householder QR of an m x n matrix, A * P = Q * R. Reflectors are grouped
+// in blocks of kBlock columns in compact WY form (I - V * T * V^T), so the
+// trailing update and every later product with Q go through Gemm. With
+// pivoting each step takes the column of largest remaining norm, which
+// makes Rank() reliable for rank-deficient inputs.
+class S21QR {
+ private:
+  S21Matrix qr_;  // R on and above the diagonal, reflectors below it
+  vector<double> tau_;
+  vector<int> perm_;
+  int rank_;
+  bool pivoting_;
+  static constexpr int kBlock = 32;
+  void factorBlocked();
+  void factorPivoted();
+  // V (rows k.. of reflectors k..k+kb-1) and T such that
+  // H_k * ... * H_{k+kb-1} = I - V * T * V^T
+  void blockReflector(int k, int kb, S21Matrix& v, S21Matrix& t) const;
+
+ public:
+  explicit S21QR(const S21Matrix& matrix, bool pivoting = false);
+
+  S21Matrix Q() const;  // m x min(m, n) with orthonormal columns
+  S21Matrix R() const;  // min(m, n) x n, upper triangular
+  // column j of A * P is column Permutation()[j] of A
+  const vector<int>& Permutation() const noexcept;
+  int Rank() const noexcept;
+  // x minimizing ||A * x - b|| for each column of b (m x k), n x k; without
+  // pivoting a rank-deficient A throws ERROR_CALC, with it the basic
+  // solution (zeros in the dependent columns) is returned
+  S21Matrix LeastSquares(const S21Matrix& b) const;
+};
+
+#endif  // SRC_S21_MATRIX_QR_H_
@@ -0,0 +1,97 @@
+#include "s21_matrix_view.h"
+
+using namespace std;
+
+#define VIEW_TILE 32
+
+S21MatrixView::S21MatrixView(double* data, int rows, int cols, int row_stride,
+                             int col_stride) {
+  if (data == nullptr || rows <= 0 || cols <= 0) throw ERROR_MATRIX;
+  data_ = data;
+  rows_ = rows;
+  cols_ = cols;
+  row_stride_ = row_stride;
+  col_stride_ = col_stride;
+}
+
+S21MatrixView S21MatrixView::RowMajor(double* data, int rows, int cols,
+                                      int ld) {
+  if (ld == 0) ld = cols;
+  if (ld < cols) throw ERROR_MATRIX;
+  return S21MatrixView(data, rows, cols, ld, 1);
+}
+
+S21MatrixView S21MatrixView::ColumnMajor(double* data, int rows, int cols,
+                                         int ld) {
+  if (ld == 0) ld = rows;
+  if (ld < rows) throw ERROR_MATRIX;
+  return S21MatrixView(data, rows, cols, 1, ld);
+}
+
+S21MatrixView S21MatrixView::Of(S21Matrix& matrix) {
+  return RowMajor(matrix.data(), matrix.rows(), matrix.columns(),
+                  matrix.leadingDimension());
+}
+
+int S21MatrixView::rows() const noexcept { return rows_; }
+
+int S21MatrixView::columns() const noexcept { return cols_; }
+
+double* S21MatrixView::data() const noexcept { return data_; }
+
+bool S21MatrixView::isRowMajor() const noexcept { return col_stride_ == 1; }
+
+bool S21MatrixView::isColumnMajor() const noexcept {
+  return row_stride_ == 1;
+}
+
+double& S21MatrixView::operator()(int r, int c) const {
+  if (r >= rows_ || c >= cols_ || r < 0 || c < 0) throw ERROR_MATRIX;
+  return data_[static_cast<ptrdiff_t>(r) * row_stride_ +
+               static_cast<ptrdiff_t>(c) * col_stride_];
+}
+
+S21MatrixView S21MatrixView::Transpose() const noexcept {
+  S21MatrixView result(*this);
+  swap(result.rows_, result.cols_);
+  swap(result.row_stride_, result.col_stride_);
+  return result;
+}
+
+S21Matrix S21MatrixView::ToMatrix() const {
+  S21Matrix result(rows_, cols_);
+  double* out = result.data();
+  int ld = result.leadingDimension();
+  // tiles keep both sides of a transposing copy in cache
+  for (int i0 = 0; i0 < rows_; i0 += VIEW_TILE) {
+    int i1 = min(rows_, i0 + VIEW_TILE);
+    for (int j0 = 0; j0 < cols_; j0 += VIEW_TILE) {
+      int j1 = min(cols_, j0 + VIEW_TILE);
+      for (int i = i0; i < i1; i++) {
+        const double* in = data_ + static_cast<ptrdiff_t>(i) * row_stride_;
+        for (int j = j0; j < j1; j++)
+          out[static_cast<size_t>(i) * ld + j] =
+              in[static_cast<ptrdiff_t>(j) * col_stride_];
+      }
+    }
+  }
+  return result;
+}
+
+void S21MatrixView::Assign(const S21Matrix& other) const {
+  if (other.rows() != rows_ || other.columns() != cols_) throw ERROR_CALC;
+  const double* in = other.data();
+  int ld = other.leadingDimension();
+  for (int i0 = 0; i0 < rows_; i0 += VIEW_TILE) {
+    int i1 = min(rows_, i0 + VIEW_TILE);
+    for (int j0 = 0; j0 < cols_; j0 += VIEW_TILE) {
+      int j1 = min(cols_, j0 + VIEW_TILE);
+      for (int i = i0; i < i1; i++) {
+        double* out = data_ + static_cast<ptrdiff_t>(i) * row_stride_;
+        for (int j = j0; j < j1; j++)
+          out[static_cast<ptrdiff_t>(j) * col_stride_] =
+              in[static_cast<size_t>(i) * ld + j];
+      }
+    }
+  }
+}
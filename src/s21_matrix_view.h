@@ -0,0 +1,37 @@
+#ifndef SRC_S21_MATRIX_VIEW_H_
+#define SRC_S21_MATRIX_VIEW_H_
+
+#include "s21_matrix_oop.h"
+
+// Non-owning strided window onto a buffer owned by someone else, so row- or
+// column-major data can be read and written in place. Like a pointer, a
+// const view still allows writing the elements it refers to.
+class S21MatrixView {
+ private:
+  double* data_;
+  int rows_;
+  int cols_;
+  int row_stride_;
+  int col_stride_;
+
+ public:
+  S21MatrixView(double* data, int rows, int cols, int row_stride,
+                int col_stride);
+  static S21MatrixView RowMajor(double* data, int rows, int cols, int ld = 0);
+  static S21MatrixView ColumnMajor(double* data, int rows, int cols,
+                                   int ld = 0);
+  static S21MatrixView Of(S21Matrix& matrix);
+
+  int rows() const noexcept;
+  int columns() const noexcept;
+  double* data() const noexcept;
+  bool isRowMajor() const noexcept;
+  bool isColumnMajor() const noexcept;
+
+  double& operator()(int r, int c) const;
+  S21MatrixView Transpose() const noexcept;  // swaps the strides only
+  S21Matrix ToMatrix() const;
+  void Assign(const S21Matrix& other) const;  // copies into the buffer
+};
+
+#endif  // SRC_S21_MATRIX_VIEW_H_
@@ -0,0 +1,176 @@
+#include "s21_tuning.h"
+
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <mutex>
+
+#include "s21_matrix_oop.h"
+
+using namespace std;
+
+#define TUNE_REPEATS 3
+#define NEVER_PARALLEL 1e300  // finite, so the profile reads back with >>
+#define TUNING_DEFAULTS \
+  { 128, 512, 16, 4e6 }
+
+// Current() runs on every Gemm, including from concurrent LU tasks, so it
+// reads an immutable published snapshot without locking. Set() publishes a
+// new one; old snapshots are never freed because a reader may still be
+// copying them, but equal values reuse their snapshot, so the store only
+// grows with the number of distinct tunings ever applied.
+static const S21Tuning tuning_defaults = TUNING_DEFAULTS;
+static atomic<const S21Tuning*> tuning_current(&tuning_defaults);
+static mutex tuning_mutex;  // writers only
+static deque<S21Tuning> tuning_snapshots;
+static once_flag tuning_loaded;
+
+static bool sameTuning(const S21Tuning& a, const S21Tuning& b) noexcept {
+  return a.block_k == b.block_k && a.block_n == b.block_n &&
+         a.row_chunk == b.row_chunk &&
+         a.parallel_threshold == b.parallel_threshold;
+}
+
+static void loadOnce() {
+  bool tune = false;
+  call_once(tuning_loaded, [&tune] {
+    tune = !S21Autotuner::Load(S21Autotuner::ProfilePath()) &&
+           getenv("S21_MATRIX_AUTOTUNE") != nullptr;
+  });
+  if (tune) {  // outside call_once: the benchmark itself calls Current()
+    S21Autotuner::Tune();
+    S21Autotuner::Save(S21Autotuner::ProfilePath());
+  }
+}
+
+static double timeMultiply(const S21Matrix& a, const S21Matrix& b,
+                           S21Matrix& c) {
+  double best = HUGE_VAL;
+  for (int r = 0; r < TUNE_REPEATS; r++) {
+    auto start = chrono::steady_clock::now();
+    Gemm(1.0, a, b, 0.0, c);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+static S21Matrix randomMatrix(int rows, int cols) {
+  S21Matrix result(rows, cols);
+  unsigned seed = 12345;
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      seed = seed * 1103515245u + 12345u;
+      result(i, j) = static_cast<double>(seed >> 8) / (1u << 24) - 0.5;
+    }
+  }
+  return result;
+}
+
+S21Tuning S21Autotuner::Defaults() noexcept { return tuning_defaults; }
+
+S21Tuning S21Autotuner::Current() {
+  loadOnce();
+  return *tuning_current.load(memory_order_acquire);
+}
+
+void S21Autotuner::Set(const S21Tuning& tuning) {
+  if (tuning.block_k <= 0 || tuning.block_n <= 0 || tuning.row_chunk <= 0)
+    throw ERROR_CALC;
+  lock_guard<mutex> lock(tuning_mutex);
+  const S21Tuning* snapshot = &tuning_defaults;
+  if (!sameTuning(tuning, tuning_defaults)) {
+    auto it = find_if(tuning_snapshots.begin(), tuning_snapshots.end(),
+                      [&tuning](const S21Tuning& kept) {
+                        return sameTuning(kept, tuning);
+                      });
+    if (it == tuning_snapshots.end())
+      it = tuning_snapshots.insert(tuning_snapshots.end(), tuning);
+    snapshot = &*it;
+  }
+  tuning_current.store(snapshot, memory_order_release);
+}
+
+string S21Autotuner::ProfilePath() {
+  const char* path = getenv("S21_MATRIX_PROFILE");
+  return path != nullptr ? path : ".s21_matrix_profile";
+}
+
+bool S21Autotuner::Load(const string& path) {
+  ifstream in(path);
+  if (!in) return false;
+  S21Tuning tuning = Defaults();
+  string key;
+  double value;
+  while (getline(in, key, '=') && in >> value) {
+    in.ignore(1);  // newline
+    if (key == "block_k") tuning.block_k = static_cast<int>(value);
+    if (key == "block_n") tuning.block_n = static_cast<int>(value);
+    if (key == "row_chunk") tuning.row_chunk = static_cast<int>(value);
+    if (key == "parallel_threshold") tuning.parallel_threshold = value;
+  }
+  try {
+    Set(tuning);
+  } catch (const int) {
+    return false;
+  }
+  return true;
+}
+
+bool S21Autotuner::Save(const string& path) {
+  S21Tuning tuning = Current();
+  ofstream out(path);
+  out << "block_k=" << tuning.block_k << '\n'
+      << "block_n=" << tuning.block_n << '\n'
+      << "row_chunk=" << tuning.row_chunk << '\n'
+      << "parallel_threshold=" << tuning.parallel_threshold << '\n';
+  return static_cast<bool>(out);
+}
+
+S21Tuning S21Autotuner::Tune(int size) {
+  if (size <= 0) throw ERROR_CALC;
+  S21Tuning best = Defaults();
+  best.parallel_threshold = NEVER_PARALLEL;  // tile sizes are chosen serially
+  S21Matrix a = randomMatrix(size, size), b = randomMatrix(size, size);
+  S21Matrix c(size, size);
+  double best_time = HUGE_VAL;
+  for (int block_k : {32, 64, 128, 256}) {
+    for (int block_n : {128, 256, 512, 1024}) {
+      S21Tuning candidate = best;
+      candidate.block_k = block_k;
+      candidate.block_n = block_n;
+      Set(candidate);
+      double elapsed = timeMultiply(a, b, c);
+      if (elapsed < best_time) best_time = elapsed, best = candidate;
+    }
+  }
+  for (int row_chunk : {4, 8, 16, 32, 64}) {  // parallel at full size
+    if (S21Executor::Instance().threads() <= 1) break;
+    S21Tuning candidate = best;
+    candidate.row_chunk = row_chunk;
+    candidate.parallel_threshold = 0;
+    Set(candidate);
+    double elapsed = timeMultiply(a, b, c);
+    if (elapsed < best_time) best_time = elapsed, best = candidate;
+  }
+  if (best.parallel_threshold == 0) {  // smallest cube where threads pay off
+    best.parallel_threshold = NEVER_PARALLEL;
+    for (int n = 16; n <= size; n *= 2) {
+      S21Matrix x = randomMatrix(n, n), y = randomMatrix(n, n), z(n, n);
+      S21Tuning serial = best, parallel = best;
+      parallel.parallel_threshold = 0;
+      Set(serial);
+      double serial_time = timeMultiply(x, y, z);
+      Set(parallel);
+      if (timeMultiply(x, y, z) < serial_time) {
+        best.parallel_threshold = static_cast<double>(n) * n * n;
+        break;
+      }
+    }
+  }
+  Set(best);
+  return best;
+}
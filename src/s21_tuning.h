@@ -0,0 +1,33 @@
+#ifndef SRC_S21_TUNING_H_
+#define SRC_S21_TUNING_H_
+
+#include <string>
+
+using namespace std;
+
+// Host-dependent parameters of the blocked/parallel multiply kernel
+struct S21Tuning {
+  int block_k;                  // depth of a k-panel kept in cache
+  int block_n;                  // width of a column strip of B and C
+  int row_chunk;                // rows of C handed to one task
+  double parallel_threshold;    // m*n*k above which the pool is used
+};
+
+// Holds the active S21Tuning. On first use it loads the profile file
+// (S21_MATRIX_PROFILE or ./.s21_matrix_profile); if none exists and
+// S21_MATRIX_AUTOTUNE is set it benchmarks once and writes the profile,
+// otherwise it keeps the built-in defaults.
+class S21Autotuner {
+ public:
+  static S21Tuning Defaults() noexcept;
+  static S21Tuning Current();  // lock-free, safe from concurrent kernels
+  static void Set(const S21Tuning& tuning);
+
+  static string ProfilePath();
+  static bool Load(const string& path);
+  static bool Save(const string& path);
+  // times every candidate on a size x size multiply and applies the winner
+  static S21Tuning Tune(int size = 256);
+};
+
+#endif  // SRC_S21_TUNING_H_
@@ -1,6 +1,19 @@
 #include <gtest/gtest.h>
+#include <sys/stat.h>
 
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "../s21_matrix_cache.h"
+#include "../s21_matrix_inverse.h"
+#include "../s21_matrix_io.h"
+#include "../s21_matrix_kronecker.h"
 #include "../s21_matrix_oop.h"
+#include "../s21_matrix_packed.h"
+#include "../s21_matrix_qr.h"
+#include "../s21_matrix_view.h"
+#include "../s21_tuning.h"
 
 TEST(EqMatrix, True) {
   S21Matrix matrix_a(3, 3);
@@ -556,6 +569,37 @@ TEST(Inverse, True) {
     ASSERT_TRUE(a == ERROR_CALC);
   }
 }
+TEST(Inverse, ScaleInvariant) {
+  S21Matrix half(30, 30);  // det 2^-30, but perfectly conditioned
+  for (int i = 0; i < 30; i++) half(i, i) = 0.5;
+  S21Matrix twice = half.InverseMatrix();
+  ASSERT_TRUE(twice == half * 4);
+  half(29, 0) = 1e-3;  // general, not triangular
+  half(0, 29) = 1e-3;
+  ASSERT_TRUE(half * half.InverseMatrix() == twice * 0.5);
+
+  int n = 200;
+  S21Matrix matrix_a(n, n);
+  S21Matrix identity(n, n);
+  unsigned seed = 7;
+  for (int i = 0; i < n; i++) {
+    identity(i, i) = 1;
+    for (int j = 0; j < n; j++) {
+      seed = seed * 1103515245u + 12345u;
+      matrix_a(i, j) = 0.1 * (static_cast<double>(seed >> 8) / (1 << 24) -
+                              0.5);
+    }
+  }
+  ASSERT_TRUE(matrix_a * matrix_a.InverseMatrix() == identity);
+  S21Matrix huge = matrix_a * 1e200;  // the pivot product overflows
+  ASSERT_TRUE(huge * huge.InverseMatrix() == identity);
+  for (int j = 0; j < n; j++) huge(n - 1, j) = huge(0, j) + huge(1, j);
+  ASSERT_THROW(huge.InverseMatrix(), int);
+  for (int j = 0; j < n; j++)
+    matrix_a(n - 1, j) = matrix_a(0, j) - matrix_a(1, j);
+  ASSERT_THROW(matrix_a.InverseMatrix(), int);
+}
+
 TEST(Get, True) {
   S21Matrix matrix_a(3, 3);
 
@@ -644,6 +688,1229 @@ TEST(Set, True) {
   ASSERT_TRUE(matrix_c == result_c);
 }
 
+TEST(MulMatrixMixed, True) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(3, 2);
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 3; j++) {
+      matrix_a(i, j) = i + j * 0.5;
+      matrix_b(j, i) = i - j * 0.25;
+    }
+  S21Matrix result = matrix_a * matrix_b;
+  matrix_a.MulMatrixMixed(matrix_b);
+  ASSERT_TRUE(matrix_a == result);
+}
+
+TEST(MulMatrixMixed, False) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(2, 3);
+  ASSERT_THROW(matrix_a.MulMatrixMixed(matrix_b), int);
+}
+
+TEST(SolveMixed, True) {
+  int n = 6;
+  S21Matrix hilbert(n, n);
+  S21Matrix x(n, 1);
+  for (int i = 0; i < n; i++) {
+    x(i, 0) = i + 1;
+    for (int j = 0; j < n; j++) hilbert(i, j) = 1.0 / (i + j + 1);
+  }
+  S21Matrix b = hilbert * x;
+  ASSERT_TRUE(hilbert.SolveMixed(b) == x);
+}
+
+TEST(SolveMixed, Refined) {
+  int n = 320;  // one right-hand side: the float LU path
+  S21Matrix a(n, n), b(n, n), rhs(n, 1);
+  for (int i = 0; i < n; i++) {
+    rhs(i, 0) = i % 7 - 3;
+    for (int j = 0; j < n; j++) {
+      a(i, j) = sin(i * 0.37 + j * 1.13) + (i == j ? 4.0 : 0.0);
+      b(i, j) = cos(i * 0.71 - j * 0.29);
+    }
+  }
+  S21Matrix x = a.SolveMixed(rhs);  // float alone leaves about 1e-6
+  ASSERT_LT((a * x - rhs).NormMax(), 1e-10 * rhs.NormMax());
+  S21Matrix many = a.SolveMixed(b);  // n right-hand sides: double LU
+  ASSERT_LT((a * many - b).NormMax(), 1e-10 * b.NormMax());
+  S21Matrix singular(n, n);
+  ASSERT_THROW(singular.SolveMixed(rhs), int);
+}
+
+TEST(MulMatrixMixed, DoubleAccumulation) {
+  int n = 300;
+  S21Matrix a(n, n), b(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {  // already exact in float
+      a(i, j) = static_cast<float>(sin(i * 0.37 + j * 1.13));
+      b(i, j) = static_cast<float>(cos(i * 0.71 - j * 0.29));
+    }
+  }
+  S21Matrix product = a * b, mixed = a;
+  mixed.MulMatrixMixed(b);  // float sums would be off by about 1e-6
+  ASSERT_LT((mixed - product).NormMax(), 1e-12 * product.NormMax());
+}
+
+TEST(MulMatrixAsync, True) {
+  S21Matrix matrix_a(2, 2);
+  S21Matrix matrix_b(2, 2);
+  matrix_a(0, 0) = 3;
+  matrix_a(0, 1) = 2;
+  matrix_a(1, 0) = -6.6;
+  matrix_b(0, 0) = -7;
+  matrix_b(1, 0) = -3.5;
+  matrix_b(1, 1) = 2;
+  S21Future<S21Matrix> product = matrix_a.MulMatrixAsync(matrix_b);
+  ASSERT_TRUE(product.get() == matrix_a * matrix_b);
+  ASSERT_TRUE(product.ready());
+}
+
+TEST(MulMatrixAsync, False) {
+  S21Matrix matrix_a(2, 1);
+  S21Matrix matrix_b(2, 2);
+  S21Future<S21Matrix> product = matrix_a.MulMatrixAsync(matrix_b);
+  S21Future<double> det = DeterminantAsync(product);
+  try {
+    det.get();
+    FAIL();
+  } catch (const int a) {
+    ASSERT_TRUE(a == ERROR_CALC);
+  }
+}
+
+TEST(InverseMatrixAsync, Chain) {
+  S21Matrix matrix_a(2, 2);
+  matrix_a(0, 0) = 4;
+  matrix_a(0, 1) = 7;
+  matrix_a(1, 0) = 2;
+  matrix_a(1, 1) = 6;
+  S21Future<S21Matrix> a = S21Future<S21Matrix>::Ready(matrix_a);
+  S21Future<S21Matrix> inverse = InverseMatrixAsync(a);
+  S21Future<S21Matrix> identity = MulMatrixAsync(a, inverse);
+  S21Future<double> trace = identity.Then(
+      [](const S21Matrix& m) { return m(0, 0) + m(1, 1); });
+  S21Future<S21Matrix> doubled = SumMatrixAsync(identity, identity);
+  ASSERT_NEAR(trace.get(), 2.0, M_DIF);
+  ASSERT_NEAR(doubled.get()(1, 1), 2.0, M_DIF);
+  ASSERT_NEAR(matrix_a.DeterminantAsync().get(), 10.0, M_DIF);
+}
+
+TEST(CopyOnWrite, True) {
+  S21Matrix::SetCopyOnWrite(true);
+  S21Matrix source(2, 2);
+  source(0, 0) = 1;
+  source(1, 1) = 2;
+  S21Matrix matrix_a = source * 1.0;  // no reference into it handed out
+  S21Matrix matrix_b(matrix_a);
+  S21Matrix matrix_c;
+  matrix_c = matrix_a;
+  ASSERT_TRUE(matrix_a.isShared());
+  ASSERT_TRUE(matrix_b.isShared());
+  const S21Matrix& read_only = matrix_b;
+  ASSERT_EQ(read_only(1, 1), 2);
+  ASSERT_TRUE(matrix_b.isShared());
+  matrix_b(0, 0) = 5;
+  ASSERT_FALSE(matrix_b.isShared());
+  ASSERT_EQ(matrix_a(0, 0), 1);
+  ASSERT_EQ(matrix_c(0, 0), 1);
+  matrix_c *= 3;
+  ASSERT_FALSE(matrix_a.isShared());
+  ASSERT_EQ(matrix_a(1, 1), 2);
+  ASSERT_EQ(matrix_c(1, 1), 6);
+  S21Matrix::SetCopyOnWrite(false);
+}
+
+TEST(CopyOnWrite, HeldReference) {
+  S21Matrix::SetCopyOnWrite(true);
+  S21Matrix source(2, 2);
+  S21Matrix matrix_a = source * 1.0;
+  double& element = matrix_a(0, 0);
+  S21Matrix matrix_b = matrix_a;
+  ASSERT_FALSE(matrix_a.isShared());
+  element = 5;
+  ASSERT_EQ(matrix_b(0, 0), 0);
+  S21Matrix matrix_c = source * 1.0;
+  double* data = matrix_c.data();
+  S21Matrix matrix_d = matrix_c;
+  data[3] = 7;
+  ASSERT_EQ(matrix_d(1, 1), 0);
+  ASSERT_EQ(matrix_c(1, 1), 7);
+  S21Matrix::SetCopyOnWrite(false);
+}
+
+TEST(CopyOnWrite, Threads) {
+  S21Matrix::SetCopyOnWrite(true);
+  S21Matrix source(64, 64);
+  S21Matrix shared = source * 1.0;
+  vector<thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&shared, t] {
+      for (int r = 0; r < 50; r++) {
+        S21Matrix copy(shared);
+        copy.MulNumber(t + 1.0);
+        copy += shared;
+        ASSERT_EQ(shared.Reduce(0.0, [](double a, double b) { return a + b; }),
+                  0.0);
+      }
+    });
+  }
+  for (thread& worker : threads) worker.join();
+  S21Matrix::SetCopyOnWrite(false);
+}
+
+TEST(CopyOnWrite, False) {
+  ASSERT_FALSE(S21Matrix::CopyOnWrite());
+  S21Matrix matrix_a(2, 2);
+  S21Matrix matrix_b(matrix_a);
+  ASSERT_FALSE(matrix_a.isShared());
+  ASSERT_FALSE(matrix_b.isShared());
+}
+
+TEST(S21Inverse, RankOneUpdate) {
+  S21Matrix matrix_a(3, 3);
+  S21Matrix u(3, 1);
+  S21Matrix v(3, 1);
+  matrix_a(0, 0) = 2;
+  matrix_a(0, 1) = 5;
+  matrix_a(0, 2) = 7;
+  matrix_a(1, 0) = 6;
+  matrix_a(1, 1) = 3;
+  matrix_a(1, 2) = 4;
+  matrix_a(2, 0) = 5;
+  matrix_a(2, 1) = -2;
+  matrix_a(2, 2) = -3;
+  u(0, 0) = 1;
+  u(2, 0) = -0.5;
+  v(1, 0) = 2;
+  v(2, 0) = 0.25;
+
+  S21Inverse inverse(matrix_a);
+  ASSERT_NEAR(inverse.Determinant(), -1, M_DIF);
+  inverse.RankOneUpdate(u, v);
+  matrix_a += u * v.Transpose();
+  ASSERT_TRUE(inverse.Matrix() == matrix_a);
+  ASSERT_TRUE(inverse.Inverse() == matrix_a.InverseMatrix());
+  ASSERT_NEAR(inverse.Determinant(), matrix_a.Determinant(), M_DIF);
+}
+
+TEST(S21Inverse, RankKUpdate) {
+  S21Matrix matrix_a(3, 3);
+  S21Matrix u(3, 2);
+  S21Matrix v(3, 2);
+  for (int i = 0; i < 3; i++) {
+    matrix_a(i, i) = 4 + i;
+    matrix_a(i, (i + 1) % 3) = 1;
+    u(i, 0) = i;
+    u(i, 1) = 1;
+    v(i, 0) = 0.5;
+    v(i, 1) = -0.25 * i;
+  }
+  S21Inverse inverse(matrix_a);
+  inverse.RankKUpdate(u, v);
+  matrix_a += u * v.Transpose();
+  ASSERT_TRUE(inverse.Inverse() == matrix_a.InverseMatrix());
+  ASSERT_NEAR(inverse.Determinant(), matrix_a.Determinant(), 1e-6);
+}
+
+TEST(S21Inverse, ReplaceRowColumn) {
+  S21Matrix matrix_a(3, 3);
+  S21Matrix row(1, 3);
+  S21Matrix column(3, 1);
+  for (int i = 0; i < 3; i++) {
+    matrix_a(i, i) = 2;
+    matrix_a(0, i) += 1;
+    row(0, i) = i - 1;
+    column(i, 0) = 3 - i;
+  }
+  S21Inverse inverse(matrix_a);
+  const S21Matrix before = inverse.Inverse();
+  inverse.ReplaceRow(2, row);
+  inverse.ReplaceColumn(0, column);
+  for (int i = 0; i < 3; i++) {
+    matrix_a(2, i) = row(0, i);
+    matrix_a(i, 0) = column(i, 0);
+  }
+  ASSERT_TRUE(inverse.Matrix() == matrix_a);
+  ASSERT_TRUE(inverse.Inverse() == matrix_a.InverseMatrix());
+  ASSERT_NEAR(inverse.Determinant(), matrix_a.Determinant(), M_DIF);
+  ASSERT_FALSE(before == inverse.Inverse());
+}
+
+TEST(S21Inverse, False) {
+  S21Matrix matrix_a(2, 2);
+  ASSERT_THROW(S21Inverse inverse(matrix_a), int);
+  matrix_a(0, 0) = 1;
+  matrix_a(1, 1) = 1;
+  S21Inverse inverse(matrix_a);
+  S21Matrix row(1, 2);
+  row(0, 0) = 1;
+  ASSERT_THROW(inverse.ReplaceRow(1, row), int);
+  ASSERT_THROW(inverse.ReplaceRow(2, row), int);
+  ASSERT_NEAR(inverse.Determinant(), 1, M_DIF);
+  ASSERT_TRUE(inverse.Inverse() == matrix_a);
+}
+
+TEST(S21Inverse, ScaleInvariant) {
+  int n = 30;
+  S21Matrix matrix_a(n, n);
+  for (int i = 0; i < n; i++) matrix_a(i, i) = 0.5;
+  S21Inverse inverse(matrix_a);  // det = 2^-30, far below M_DIF
+  S21Matrix u(n, 1), v(n, 1);
+  u(0, 0) = 0.5;
+  v(1, 0) = 1;
+  for (int r = 0; r < 20; r++) inverse.RankOneUpdate(u * 0.0, v);
+  inverse.RankOneUpdate(u, v);
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  ASSERT_TRUE(inverse.Matrix() * inverse.Inverse() == identity);
+  ASSERT_NEAR(inverse.Determinant() / pow(0.5, n), 1.0, 1e-12);
+  S21Matrix row(1, n);
+  for (int j = 0; j < n; j++) row(0, j) = inverse.Matrix()(0, j);
+  ASSERT_THROW(inverse.ReplaceRow(1, row), int);  // two equal rows
+  S21Matrix huge = identity * 1e200;
+  ASSERT_THROW(S21Inverse(huge * 0.0), int);
+  S21Inverse scaled(huge);
+  ASSERT_NEAR(scaled.Inverse()(3, 3), 1e-200, 1e-210);
+}
+
+TEST(Capacity, AppendRow) {
+  S21Matrix matrix_a;
+  S21Matrix row(1, 3);
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 3; j++) row(0, j) = i * 3 + j;
+    matrix_a.appendRow(row);
+  }
+  ASSERT_EQ(matrix_a.rows(), 100);
+  ASSERT_EQ(matrix_a.columns(), 3);
+  ASSERT_GE(matrix_a.capacityRows(), 100);
+  ASSERT_LT(matrix_a.capacityRows(), 200);
+  for (int i = 0; i < 100; i++)
+    for (int j = 0; j < 3; j++) ASSERT_EQ(matrix_a(i, j), i * 3 + j);
+  S21Matrix wrong(1, 2);
+  ASSERT_THROW(matrix_a.appendRow(wrong), int);
+  double values[3] = {1, 2, 3};
+  matrix_a.appendRow(values, 3);
+  ASSERT_EQ(matrix_a(100, 2), 3);
+}
+
+TEST(Capacity, ReserveAndShrink) {
+  S21Matrix matrix_a(2, 2);
+  matrix_a(1, 1) = 7;
+  matrix_a.reserve(10, 8);
+  ASSERT_EQ(matrix_a.capacityRows(), 10);
+  ASSERT_EQ(matrix_a.capacityColumns(), 8);
+  ASSERT_EQ(matrix_a(1, 1), 7);
+  matrix_a.setColumns(8);
+  matrix_a.setRows(10);
+  ASSERT_EQ(matrix_a.capacityRows(), 10);
+  ASSERT_EQ(matrix_a(9, 7), 0);
+  matrix_a(9, 7) = 1;
+  matrix_a(1, 5) = 1;
+  matrix_a.setRows(2);
+  matrix_a.setColumns(2);
+  ASSERT_EQ(matrix_a.capacityColumns(), 8);
+  matrix_a.setRows(10);
+  matrix_a.setColumns(8);
+  ASSERT_EQ(matrix_a(9, 7), 0);
+  ASSERT_EQ(matrix_a(1, 5), 0);
+  ASSERT_EQ(matrix_a(1, 1), 7);
+  matrix_a.setRows(3);
+  matrix_a.shrinkToFit();
+  ASSERT_EQ(matrix_a.capacityRows(), 3);
+  ASSERT_EQ(matrix_a.capacityColumns(), 8);
+  ASSERT_THROW(matrix_a.reserve(0, 1), int);
+}
+
+TEST(Capacity, AppendOwnRow) {
+  S21Matrix matrix_a(2, 3);
+  for (int j = 0; j < 3; j++) matrix_a(0, j) = j + 1, matrix_a(1, j) = -j;
+  matrix_a.appendRow(matrix_a.data(), 3);  // full: the buffer is replaced
+  matrix_a.appendRow(&matrix_a(1, 0), 3);
+  matrix_a.appendRow(&matrix_a(3, 0), 3);  // full again
+  ASSERT_EQ(matrix_a.rows(), 5);
+  for (int j = 0; j < 3; j++) {
+    ASSERT_EQ(matrix_a(2, j), j + 1);
+    ASSERT_EQ(matrix_a(3, j), -j);
+    ASSERT_EQ(matrix_a(4, j), -j);
+  }
+}
+
+TEST(Capacity, ReserveThenAppend) {
+  S21Matrix matrix_a;
+  matrix_a.reserve(4, 2);  // narrower than the rows appended below
+  double values[5] = {1, 2, 3, 4, 5};
+  for (int i = 0; i < 6; i++) matrix_a.appendRow(values, 5);
+  ASSERT_EQ(matrix_a.rows(), 6);
+  ASSERT_GE(matrix_a.capacityColumns(), 5);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 5; j++) ASSERT_EQ(matrix_a(i, j), j + 1);
+  S21Matrix matrix_b;
+  matrix_b.reserve(4, 8);
+  matrix_b.appendRow(values, 5);
+  ASSERT_EQ(matrix_b.capacityRows(), 4);
+  ASSERT_EQ(matrix_b(0, 4), 5);
+}
+
+TEST(Capacity, CopyOnWrite) {
+  S21Matrix::SetCopyOnWrite(true);
+  S21Matrix matrix_a(2, 2);
+  matrix_a.reserve(4, 2);
+  S21Matrix matrix_b(matrix_a);
+  S21Matrix row(1, 2);
+  row(0, 0) = 5;
+  matrix_b.appendRow(row);
+  matrix_a.setRows(3);
+  ASSERT_EQ(matrix_a(2, 0), 0);
+  ASSERT_EQ(matrix_b(2, 0), 5);
+  S21Matrix::SetCopyOnWrite(false);
+}
+
+TEST(Gemm, True) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(3, 2);
+  S21Matrix matrix_c(2, 2);
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      matrix_a(i, j) = i * 3 + j - 2;
+      matrix_b(j, i) = 0.5 * j - i;
+    }
+    matrix_c(i, i) = 1;
+    matrix_c(i, 1 - i) = -2;
+  }
+  S21Matrix result = 2 * (matrix_a * matrix_b) + matrix_c * 3;
+  Gemm(2, matrix_a, matrix_b, 3, matrix_c);
+  ASSERT_TRUE(matrix_c == result);
+
+  S21Matrix at = matrix_a.Transpose(), bt = matrix_b.Transpose();
+  Gemm(1, at, matrix_b, 0, matrix_c, true);
+  ASSERT_TRUE(matrix_c == matrix_a * matrix_b);
+  Gemm(1, matrix_a, bt, 0, matrix_c, false, true);
+  ASSERT_TRUE(matrix_c == matrix_a * matrix_b);
+  Gemm(-1, at, bt, 1, matrix_c, true, true);
+  ASSERT_TRUE(matrix_c == S21Matrix(2, 2));
+}
+
+TEST(Gemm, Aliased) {
+  S21Matrix matrix_a(2, 2);
+  matrix_a(0, 0) = 1;
+  matrix_a(0, 1) = 2;
+  matrix_a(1, 0) = 3;
+  matrix_a(1, 1) = 4;
+  S21Matrix result = matrix_a * matrix_a + matrix_a;
+  Gemm(1, matrix_a, matrix_a, 1, matrix_a);
+  ASSERT_TRUE(matrix_a == result);
+}
+
+TEST(Gemm, False) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(3, 2);
+  S21Matrix matrix_c(3, 3);
+  ASSERT_THROW(Gemm(1, matrix_a, matrix_b, 0, matrix_c), int);
+  ASSERT_THROW(Gemm(1, matrix_a, matrix_b, 0, matrix_c, false, true), int);
+}
+
+TEST(Axpy, True) {
+  S21Matrix matrix_x(2, 3);
+  S21Matrix matrix_y(2, 3);
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 3; j++) {
+      matrix_x(i, j) = i + j;
+      matrix_y(i, j) = i - j;
+    }
+  S21Matrix result = matrix_y + matrix_x * -0.5;
+  Axpy(-0.5, matrix_x, matrix_y);
+  ASSERT_TRUE(matrix_y == result);
+  S21Matrix wrong(3, 2);
+  ASSERT_THROW(Axpy(1, wrong, matrix_y), int);
+}
+
+TEST(ExternalBuffer, Borrowed) {
+  double buffer[8] = {1, 2, 3, -1, 4, 5, 6, -1};
+  S21Matrix matrix_a(buffer, 2, 3, 4);
+  ASSERT_EQ(matrix_a.leadingDimension(), 4);
+  ASSERT_EQ(matrix_a(1, 0), 4);
+  matrix_a(1, 2) = 60;
+  ASSERT_EQ(buffer[6], 60);
+  matrix_a.setColumns(4);
+  ASSERT_EQ(matrix_a(0, 3), 0);
+  ASSERT_EQ(buffer[3], -1);
+  ASSERT_THROW(S21Matrix(buffer, 2, 3, 2), int);
+}
+
+TEST(ExternalBuffer, OwnedAndReleased) {
+  static int freed = 0;
+  double* buffer = new double[4]{1, 2, 3, 4};
+  {
+    S21Matrix matrix_a(buffer, 2, 2, 0, [](double* p) {
+      freed++;
+      delete[] p;
+    });
+    S21Matrix matrix_b = matrix_a * 2;
+    ASSERT_EQ(matrix_b(1, 1), 8);
+  }
+  ASSERT_EQ(freed, 1);
+
+  buffer = new double[4]{1, 2, 3, 4};
+  S21Matrix matrix_c(buffer, 2, 2, 0, [](double* p) {
+    freed++;
+    delete[] p;
+  });
+  double* released = matrix_c.release();
+  ASSERT_EQ(released, buffer);
+  ASSERT_EQ(matrix_c.rows(), 0);
+  ASSERT_EQ(freed, 1);
+  delete[] released;
+
+  S21Matrix matrix_d(2, 2);
+  matrix_d(1, 0) = 5;
+  released = matrix_d.release();
+  ASSERT_EQ(released[2], 5);
+  delete[] released;
+}
+
+TEST(ExternalBuffer, ReleaseLayout) {
+  S21Matrix matrix_a(2, 3);
+  matrix_a.reserve(5, 8);
+  matrix_a(1, 2) = 7;
+  int ld = 0;
+  double* released = matrix_a.release(&ld);
+  ASSERT_EQ(ld, 3);
+  ASSERT_EQ(released[5], 7);
+  delete[] released;
+
+  S21Matrix::SetCopyOnWrite(true);
+  S21Matrix matrix_b = S21Matrix(2, 2) * 1.0, matrix_c = matrix_b;
+  ASSERT_TRUE(matrix_c.isShared());
+  released = matrix_c.release(&ld);
+  released[0] = 9;
+  ASSERT_EQ(matrix_b(0, 0), 0);
+  delete[] released;
+  S21Matrix matrix_d(2, 3);
+  matrix_d(1, 2) = 5;
+  matrix_d.reserve(5, 8);  // a fresh buffer, shareable again
+  S21Matrix matrix_e = matrix_d;
+  ASSERT_TRUE(matrix_e.isShared());
+  matrix_d = S21Matrix();
+  released = matrix_e.release(&ld);  // sole owner now, but 8 wide
+  ASSERT_EQ(ld, 3);
+  ASSERT_EQ(released[5], 5);
+  delete[] released;
+  S21Matrix::SetCopyOnWrite(false);
+
+  double buffer[8] = {1, 2, 3, -1, 4, 5, 6, -1};
+  S21Matrix borrowed(buffer, 2, 3, 4);
+  ASSERT_THROW(borrowed.release(), int);
+  double* owned = new double[8]{1, 2, 3, -1, 4, 5, 6, -1};
+  S21Matrix adopted(owned, 2, 3, 4, [](double* p) { delete[] p; });
+  ASSERT_EQ(adopted.release(&ld), owned);
+  ASSERT_EQ(ld, 4);
+  delete[] owned;
+}
+
+TEST(S21MatrixView, ColumnMajor) {
+  double buffer[6] = {1, 4, 2, 5, 3, 6};  // 2 x 3, column-major
+  S21MatrixView view = S21MatrixView::ColumnMajor(buffer, 2, 3);
+  ASSERT_TRUE(view.isColumnMajor());
+  ASSERT_EQ(view(1, 1), 5);
+  S21Matrix matrix_a = view.ToMatrix();
+  ASSERT_EQ(matrix_a(0, 2), 3);
+  ASSERT_EQ(matrix_a(1, 0), 4);
+  ASSERT_TRUE(view.Transpose().ToMatrix() == matrix_a.Transpose());
+  matrix_a *= 2;
+  view.Assign(matrix_a);
+  ASSERT_EQ(buffer[5], 12);
+  S21MatrixView row_view = S21MatrixView::Of(matrix_a);
+  row_view(0, 0) = -1;
+  ASSERT_EQ(matrix_a(0, 0), -1);
+  ASSERT_THROW(view(2, 0), int);
+  ASSERT_THROW(view.Assign(S21Matrix(3, 2)), int);
+}
+
+TEST(S21MatrixCache, HitsAndMisses) {
+  S21MatrixCache::Enable(2);
+  S21Matrix matrix_a(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) matrix_a(i, j) = i == j ? 2 : 0.5;
+  double det = matrix_a.Determinant();
+  ASSERT_EQ(S21MatrixCache::Stats().misses, 1u);
+  ASSERT_EQ(matrix_a.Determinant(), det);
+  ASSERT_EQ(S21MatrixCache::Stats().hits, 1u);
+  S21Matrix inverse = matrix_a.InverseMatrix();
+  ASSERT_EQ(S21MatrixCache::Stats().misses, 2u);
+  ASSERT_TRUE(S21Matrix(matrix_a).InverseMatrix() == inverse);
+  ASSERT_EQ(matrix_a.Determinant(), det);
+  ASSERT_EQ(S21MatrixCache::Stats().hits, 3u);
+  ASSERT_EQ(S21MatrixCache::Stats().misses, 2u);
+  ASSERT_EQ(S21MatrixCache::Stats().entries, 1u);
+
+  matrix_a(0, 0) = 3;
+  ASSERT_NE(matrix_a.Determinant(), det);
+  S21Matrix matrix_b(2, 2);
+  matrix_b(0, 1) = 4;
+  matrix_b(1, 0) = 4;
+  matrix_b.Determinant();
+  ASSERT_EQ(S21MatrixCache::Stats().entries, 2u);
+  ASSERT_EQ(S21MatrixCache::Stats().evictions, 1u);
+  S21MatrixCache::Disable();
+  ASSERT_EQ(S21MatrixCache::Stats().entries, 0u);
+  matrix_a.Determinant();
+  ASSERT_EQ(S21MatrixCache::Stats().misses, 0u);
+}
+
+TEST(S21MatrixCache, OneLookupPerCall) {
+  S21MatrixCache::Enable(4);
+  S21Matrix matrix_a(40, 40);
+  for (int i = 0; i < 40; i++)
+    for (int j = 0; j < 40; j++)
+      matrix_a(i, j) = i == j ? 4 : 1.0 / (i + j + 1);
+  S21Matrix inverse = matrix_a.InverseMatrix();
+  S21CacheStats stats = S21MatrixCache::Stats();
+  ASSERT_EQ(stats.hits, 0u);
+  ASSERT_EQ(stats.misses, 1u);
+  ASSERT_EQ(stats.entries, 1u);
+  double det = matrix_a.Determinant();  // stored along with the inverse
+  ASSERT_TRUE(matrix_a.InverseMatrix() == inverse);
+  stats = S21MatrixCache::Stats();
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.misses, 1u);
+  ASSERT_GT(det, 1.0);
+
+  S21Matrix singular(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) singular(i, j) = i + j;
+  ASSERT_THROW(singular.InverseMatrix(), int);
+  ASSERT_THROW(singular.InverseMatrix(), int);
+  stats = S21MatrixCache::Stats();
+  ASSERT_EQ(stats.hits, 3u);
+  ASSERT_EQ(stats.misses, 2u);
+  ASSERT_EQ(stats.entries, 2u);
+  S21MatrixCache::Disable();
+}
+
+TEST(S21MatrixCache, Hash) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(3, 2);
+  ASSERT_NE(S21MatrixCache::Hash(matrix_a), S21MatrixCache::Hash(matrix_b));
+  S21Matrix matrix_c(matrix_a);
+  ASSERT_EQ(S21MatrixCache::Hash(matrix_a), S21MatrixCache::Hash(matrix_c));
+  matrix_c(1, 2) = 1e-300;
+  ASSERT_NE(S21MatrixCache::Hash(matrix_a), S21MatrixCache::Hash(matrix_c));
+}
+
+TEST(Structure, Detect) {
+  S21Matrix matrix_a(4, 4);
+  ASSERT_EQ(matrix_a.DetectStructure(), S21Matrix::kDiagonal);
+  matrix_a(0, 3) = 1;
+  ASSERT_EQ(matrix_a.DetectStructure(), S21Matrix::kUpperTriangular);
+  matrix_a(3, 0) = 1;
+  ASSERT_EQ(matrix_a.DetectStructure(), S21Matrix::kGeneral);
+  S21Matrix matrix_b(8, 8);
+  for (int i = 0; i < 8; i++) {
+    matrix_b(i, i) = 2;
+    if (i > 0) matrix_b(i, i - 1) = -1;
+    if (i < 7) matrix_b(i, i + 1) = -1;
+  }
+  int lower, upper;
+  matrix_b.Bandwidth(&lower, &upper);
+  ASSERT_EQ(lower, 1);
+  ASSERT_EQ(upper, 1);
+  ASSERT_EQ(matrix_b.DetectStructure(), S21Matrix::kBanded);
+  ASSERT_EQ(matrix_b.Transpose().DetectStructure(), S21Matrix::kBanded);
+  matrix_a(3, 0) = 0;
+  matrix_a(0, 3) = 0;
+  matrix_a(2, 1) = 5;
+  ASSERT_EQ(matrix_a.DetectStructure(), S21Matrix::kLowerTriangular);
+}
+
+TEST(Structure, Triangular) {
+  S21Matrix matrix_a(3, 3);
+  matrix_a(0, 0) = 2;
+  matrix_a(0, 1) = -1;
+  matrix_a(0, 2) = 4;
+  matrix_a(1, 1) = 0.5;
+  matrix_a(1, 2) = 3;
+  matrix_a(2, 2) = -4;
+  ASSERT_NEAR(matrix_a.Determinant(), -4, M_DIF);
+  S21Matrix inverse = matrix_a.InverseMatrix();
+  S21Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1;
+  ASSERT_TRUE(matrix_a * inverse == identity);
+  S21Matrix lower = matrix_a.Transpose();
+  ASSERT_TRUE(lower.InverseMatrix() == inverse.Transpose());
+  matrix_a(1, 1) = 0;
+  ASSERT_EQ(matrix_a.Determinant(), 0);
+  ASSERT_THROW(matrix_a.InverseMatrix(), int);
+}
+
+TEST(Structure, BandedMultiply) {
+  int n = 12;
+  S21Matrix matrix_a(n, n);
+  S21Matrix matrix_b(n, 3);
+  S21Matrix expected(n, 3);
+  for (int i = 0; i < n; i++) {
+    for (int j = max(0, i - 2); j < min(n, i + 2); j++) matrix_a(i, j) = i - j;
+    for (int j = 0; j < 3; j++) matrix_b(i, j) = i + j * 0.5;
+  }
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < 3; j++)
+      for (int k = 0; k < n; k++)
+        expected(i, j) += matrix_a(i, k) * matrix_b(k, j);
+  ASSERT_EQ(matrix_a.DetectStructure(), S21Matrix::kBanded);
+  ASSERT_TRUE(matrix_a * matrix_b == expected);
+  S21Matrix matrix_c(3, n);
+  Gemm(1, matrix_b, matrix_a, 0, matrix_c, true);
+  ASSERT_TRUE(matrix_c == (matrix_a.Transpose() * matrix_b).Transpose());
+}
+
+TEST(S21Autotuner, ParallelMultiply) {
+  S21Tuning saved = S21Autotuner::Current();
+  S21Tuning tuning = {8, 16, 3, 0};
+  S21Autotuner::Set(tuning);
+  S21Matrix matrix_a(37, 29);
+  S21Matrix matrix_b(29, 41);
+  for (int i = 0; i < 37; i++)
+    for (int j = 0; j < 29; j++) matrix_a(i, j) = (i * 7 + j * 3) % 11 - 5;
+  for (int i = 0; i < 29; i++)
+    for (int j = 0; j < 41; j++) matrix_b(i, j) = (i * 5 + j) % 13 - 6.5;
+  S21Matrix product = matrix_a * matrix_b;
+  S21Autotuner::Set(saved);
+  ASSERT_TRUE(product == matrix_a * matrix_b);
+  ASSERT_THROW(S21Autotuner::Set({0, 16, 3, 0}), int);
+}
+
+TEST(S21Autotuner, TuneSaveLoad) {
+  S21Tuning saved = S21Autotuner::Current();
+  S21Tuning tuned = S21Autotuner::Tune(32);
+  ASSERT_GT(tuned.block_k, 0);
+  ASSERT_GT(tuned.block_n, 0);
+  string path = testing::TempDir() + "s21_matrix_profile";
+  ASSERT_TRUE(S21Autotuner::Save(path));
+  S21Autotuner::Set(S21Autotuner::Defaults());
+  bool loaded = S21Autotuner::Load(path);
+  ASSERT_EQ(remove(path.c_str()), 0);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(S21Autotuner::Current().block_k, tuned.block_k);
+  ASSERT_EQ(S21Autotuner::Current().block_n, tuned.block_n);
+  ASSERT_EQ(S21Autotuner::Current().row_chunk, tuned.row_chunk);
+  ASSERT_FALSE(S21Autotuner::Load(path + ".missing"));
+  S21Autotuner::Set(saved);
+}
+
+TEST(S21Executor, ParallelFor) {
+  S21Executor pool(3);
+  vector<int> hits(1000, 0);
+  pool.ParallelFor(1000, 7, [&hits](int begin, int end) {
+    for (int i = begin; i < end; i++) hits[i]++;
+  });
+  for (int hit : hits) ASSERT_EQ(hit, 1);
+  ASSERT_THROW(pool.ParallelFor(1000, 7,
+                                [](int begin, int) {
+                                  if (begin % 3 == 0) throw ERROR_MATRIX;
+                                }),
+               int);
+}
+
+TEST(S21Executor, TaskGraph) {
+  S21TaskGraph graph;
+  atomic<int> clock(0);
+  vector<int> finished(4, -1);
+  for (int i = 0; i < 4; i++)
+    graph.Add([&finished, &clock, i] { finished[i] = clock++; });
+  graph.Depend(1, 0);  // diamond 0 -> {1, 2} -> 3
+  graph.Depend(2, 0);
+  graph.Depend(3, 1);
+  graph.Depend(3, 2);
+  atomic<bool> done(false);
+  S21Executor::Instance().Submit([&graph, &done] {
+    graph.Run();  // from inside a pool task
+    done = true;
+  });
+  while (!done) S21Executor::Instance().RunOne();
+  ASSERT_EQ(finished[0], 0);
+  ASSERT_EQ(finished[3], 3);
+  S21TaskGraph empty;
+  empty.Run();
+}
+
+TEST(Determinant, TiledLU) {
+  int n = 300;
+  S21Matrix lower(n, n);
+  S21Matrix upper(n, n);
+  double expected = 1.0;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < i; j++) lower(i, j) = 0.01 * sin(i + j);
+    lower(i, i) = 1;
+    upper(i, i) = 1 + (i % 3) * 0.01;
+    for (int j = i + 1; j < n; j++) upper(i, j) = 0.1 * cos(i * j);
+    expected *= upper(i, i);
+  }
+  S21Matrix matrix_a = lower * upper;
+  ASSERT_NEAR(matrix_a.Determinant() / expected, 1, 1e-9);
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  ASSERT_TRUE(matrix_a * matrix_a.InverseMatrix() == identity);
+  for (int i = 0; i < n; i++) matrix_a(i, 250) = 0;
+  ASSERT_EQ(matrix_a.Determinant(), 0);
+  ASSERT_THROW(matrix_a.InverseMatrix(), int);
+}
+
+TEST(MulChain, True) {
+  S21Matrix matrix_a(10, 30);
+  S21Matrix matrix_b(30, 5);
+  S21Matrix matrix_c(5, 60);
+  S21Matrix matrix_d(60, 1);
+  for (int i = 0; i < 60; i++) {
+    if (i < 10)
+      for (int j = 0; j < 30; j++) matrix_a(i, j) = (i + j) % 5 - 2;
+    if (i < 30)
+      for (int j = 0; j < 5; j++) matrix_b(i, j) = (i * j) % 3 - 1;
+    if (i < 5)
+      for (int j = 0; j < 60; j++) matrix_c(i, j) = (i + 2 * j) % 7 - 3;
+    matrix_d(i, 0) = i % 4 - 1.5;
+  }
+  S21Matrix expected = matrix_a * matrix_b * matrix_c * matrix_d;
+  ASSERT_TRUE(MulChain({matrix_a, matrix_b, matrix_c, matrix_d}) == expected);
+  ASSERT_TRUE(MulChain({matrix_a, matrix_b}) == matrix_a * matrix_b);
+  ASSERT_TRUE(MulChain({matrix_c}) == matrix_c);
+}
+
+TEST(MulChain, False) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(2, 3);
+  ASSERT_THROW(MulChain({matrix_a, matrix_b}), int);
+  ASSERT_THROW(MulChain(vector<const S21Matrix*>()), int);
+}
+
+TEST(MapZipReduce, True) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(2, 3);
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 3; j++) {
+      matrix_a(i, j) = i * 3 + j - 2;
+      matrix_b(i, j) = j + 1;
+    }
+  S21Matrix squared = matrix_a.Map([](double x) { return x * x; });
+  ASSERT_EQ(squared(1, 2), 9);
+  S21Matrix product =
+      matrix_a.Zip(matrix_b, [](double x, double y) { return x * y; });
+  ASSERT_EQ(product(1, 2), 9);
+  ASSERT_EQ(product(0, 0), -2);
+  double sum =
+      matrix_a.Reduce(0.0, [](double acc, double x) { return acc + x; });
+  ASSERT_EQ(sum, 3);
+  S21Matrix row_sums = matrix_a.Reduce(
+      0.0, [](double acc, double x) { return acc + x; }, S21Matrix::kRows);
+  ASSERT_EQ(row_sums.rows(), 2);
+  ASSERT_EQ(row_sums(0, 0), -3);
+  ASSERT_EQ(row_sums(1, 0), 6);
+  S21Matrix col_max = matrix_a.Reduce(
+      -HUGE_VAL, [](double acc, double x) { return fmax(acc, x); },
+      S21Matrix::kColumns);
+  ASSERT_EQ(col_max.columns(), 3);
+  ASSERT_EQ(col_max(0, 1), 2);
+  matrix_a.Apply([](double x) { return fmin(fmax(x, -1.0), 1.0); });
+  ASSERT_EQ(matrix_a(0, 0), -1);
+  ASSERT_EQ(matrix_a(1, 2), 1);
+  ASSERT_THROW(
+      matrix_a.Zip(S21Matrix(3, 3), [](double x, double) { return x; }), int);
+}
+
+TEST(MapZipReduce, Large) {
+  S21Matrix matrix_a(300, 301);
+  for (int i = 0; i < 300; i++)
+    for (int j = 0; j < 301; j++) matrix_a(i, j) = j % 2 ? 1 : -1;
+  ASSERT_EQ(matrix_a.Reduce(0.0, [](double acc, double x) { return acc + x; }),
+            -300);
+  S21Matrix twice = matrix_a.Map([](double x) { return 2 * x; });
+  ASSERT_EQ(twice.Reduce(0.0, [](double acc, double x) { return acc + x; }),
+            -600);
+  auto largest = [](double acc, double x) { return max(acc, x); };
+  S21Matrix negative = matrix_a.Map([](double x) { return 0.5 * x - 1; });
+  ASSERT_EQ(negative.Reduce(-HUGE_VAL, largest), -0.5);
+  S21Matrix columns = matrix_a.MapReduce(
+      1.0, [](double x) { return fabs(x); },
+      [](double acc, double x) { return acc + x; }, S21Matrix::kColumns);
+  for (int j = 0; j < 301; j++) ASSERT_EQ(columns(0, j), 301);
+  ASSERT_EQ(negative.Reduce(-HUGE_VAL, largest, S21Matrix::kColumns)(0, 0),
+            -1.5);
+  ASSERT_EQ(matrix_a.Norm1(), 300);
+}
+
+TEST(MapZipReduce, Throws) {
+  S21Matrix matrix_a(400, 300);  // above kParallelElements, so chunked
+  for (int i = 0; i < 400; i++)
+    for (int j = 0; j < 300; j++) matrix_a(i, j) = i * 300 + j;
+  auto fail = [](double x) {
+    if (x == 300 * 300 + 7 || x == 399 * 300) throw ERROR_CALC;
+    return x;
+  };
+  for (int round = 0; round < 20; round++) {
+    ASSERT_THROW(matrix_a.Map(fail), int);
+    ASSERT_THROW(matrix_a.Zip(matrix_a, [&fail](double x, double) {
+      return fail(x);
+    }), int);
+    ASSERT_THROW(matrix_a.MapReduce(0.0, fail, [](double acc, double x) {
+      return acc + x;
+    }), int);
+    S21Matrix copy(matrix_a);
+    ASSERT_THROW(copy.Apply(fail), int);
+  }
+  ASSERT_TRUE(matrix_a.Map([](double x) { return x; }) == matrix_a);
+}
+
+TEST(Norms, True) {
+  S21Matrix matrix_a(2, 2);
+  matrix_a(0, 0) = 3;
+  matrix_a(0, 1) = -4;
+  matrix_a(1, 0) = 0;
+  matrix_a(1, 1) = 2;
+  ASSERT_NEAR(matrix_a.NormFrobenius(), sqrt(29.0), M_DIF);
+  ASSERT_EQ(matrix_a.NormMax(), 4);
+  ASSERT_EQ(matrix_a.Norm1(), 6);
+  ASSERT_EQ(matrix_a.Trace(), 5);
+  ASSERT_THROW(S21Matrix(2, 3).Trace(), int);
+  ASSERT_EQ(S21Matrix().NormFrobenius(), 0);
+}
+
+TEST(QR, Factors) {
+  S21Matrix matrix_a(90, 70);
+  for (int i = 0; i < 90; i++)
+    for (int j = 0; j < 70; j++) matrix_a(i, j) = sin((i + 1.0) * (j + 2));
+  S21QR qr(matrix_a);
+  S21Matrix q = qr.Q(), r = qr.R();
+  ASSERT_EQ(q.rows(), 90);
+  ASSERT_EQ(q.columns(), 70);
+  ASSERT_EQ(r.rows(), 70);
+  ASSERT_EQ(r(5, 4), 0);
+  ASSERT_EQ(qr.Rank(), 70);
+  ASSERT_TRUE(q * r == matrix_a);
+  S21Matrix identity(70, 70);
+  for (int i = 0; i < 70; i++) identity(i, i) = 1;
+  ASSERT_TRUE(q.Transpose() * q == identity);
+  S21Matrix empty;
+  ASSERT_THROW(S21QR qr_empty(empty), int);
+}
+
+TEST(QR, LeastSquares) {
+  S21Matrix matrix_a(50, 3);
+  S21Matrix b(50, 1);
+  for (int i = 0; i < 50; i++) {
+    double t = i / 10.0;
+    matrix_a(i, 0) = 1;
+    matrix_a(i, 1) = t;
+    matrix_a(i, 2) = t * t;
+    b(i, 0) = 2 - 3 * t + 0.5 * t * t + (i % 2 ? 0.01 : -0.01);
+  }
+  S21Matrix normal = (matrix_a.Transpose() * matrix_a).InverseMatrix() *
+                     matrix_a.Transpose() * b;
+  S21Matrix x = S21QR(matrix_a).LeastSquares(b);
+  ASSERT_EQ(x.rows(), 3);
+  ASSERT_TRUE(x == normal);
+  ASSERT_NEAR(x(2, 0), 0.5, 1e-2);
+  S21Matrix pivoted = S21QR(matrix_a, true).LeastSquares(b);
+  ASSERT_TRUE(pivoted == normal);
+  ASSERT_THROW(S21QR(matrix_a).LeastSquares(S21Matrix(3, 1)), int);
+}
+
+TEST(QR, RankDeficient) {
+  S21Matrix matrix_a(6, 4);
+  for (int i = 0; i < 6; i++) {
+    matrix_a(i, 0) = i + 1;
+    matrix_a(i, 1) = 1;
+    matrix_a(i, 2) = 2 * (i + 1) - 3;  // 2 * col0 - 3 * col1
+    matrix_a(i, 3) = i * i;
+  }
+  S21QR pivoted(matrix_a, true);
+  ASSERT_EQ(pivoted.Rank(), 3);
+  ASSERT_EQ(pivoted.Permutation()[0], 3);
+  S21Matrix ap(6, 4);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 4; j++)
+      ap(i, j) = matrix_a(i, pivoted.Permutation()[j]);
+  ASSERT_TRUE(pivoted.Q() * pivoted.R() == ap);
+  S21Matrix b(6, 1);
+  for (int i = 0; i < 6; i++) b(i, 0) = matrix_a(i, 2) + matrix_a(i, 3);
+  S21Matrix x = pivoted.LeastSquares(b);
+  ASSERT_TRUE(matrix_a * x == b);
+  ASSERT_THROW(S21QR(matrix_a).LeastSquares(b), int);
+}
+
+TEST(PackedMatrix, Symmetric) {
+  int n = 70;
+  S21Matrix matrix_a(n, n);
+  S21Matrix b(n, 2);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) matrix_a(i, j) = 1.0 / (1 + i + j);
+    matrix_a(i, i) += n;
+    b(i, 0) = i;
+    b(i, 1) = 1;
+  }
+  for (auto triangle : {S21PackedMatrix::kLower, S21PackedMatrix::kUpper}) {
+    for (bool tiled : {false, true}) {
+      S21PackedMatrix packed(matrix_a, S21PackedMatrix::kSymmetric, triangle,
+                             tiled);
+      ASSERT_TRUE(packed.ToMatrix() == matrix_a);
+      ASSERT_EQ(packed(3, 60), matrix_a(60, 3));
+      ASSERT_TRUE(packed * b == matrix_a * b);
+      ASSERT_TRUE(matrix_a * packed.Solve(b) == b);
+    }
+  }
+  S21PackedMatrix packed(matrix_a, S21PackedMatrix::kSymmetric);
+  ASSERT_EQ(packed.storageSize(), static_cast<size_t>(n * (n + 1) / 2));
+  packed(0, 5) = 7;
+  ASSERT_EQ(packed(5, 0), 7);
+  ASSERT_THROW(packed(n, 0), int);
+  ASSERT_THROW(packed * S21Matrix(3, 1), int);
+}
+
+TEST(PackedMatrix, Determinant) {
+  S21Matrix matrix_a(4, 4);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) matrix_a(i, j) = i == j ? 4 : 1;
+  S21PackedMatrix spd(matrix_a, S21PackedMatrix::kSymmetric);
+  ASSERT_NEAR(spd.Determinant(), matrix_a.Determinant(), M_DIF);
+  matrix_a(0, 0) = -3;  // indefinite: pivoted L * D * L^T
+  S21PackedMatrix indefinite(matrix_a, S21PackedMatrix::kSymmetric,
+                             S21PackedMatrix::kUpper, true);
+  ASSERT_NEAR(indefinite.Determinant(), matrix_a.Determinant(), M_DIF);
+  S21Matrix b(4, 1);
+  b(2, 0) = 1;
+  ASSERT_TRUE(matrix_a * indefinite.Solve(b) == b);
+}
+
+TEST(PackedMatrix, Indefinite) {
+  int n = 90, m = 30;  // saddle point [H B^T; B 0], zero diagonal below
+  S21Matrix matrix_a(n, n);
+  S21Matrix b(n, 3);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= i; j++) {
+      double value = j < n - m ? sin((i + 1.0) * (j + 2)) : 0.0;
+      if (i == j && i < n - m) value = i % 2 ? 4 : -4;
+      matrix_a(i, j) = matrix_a(j, i) = value;
+    }
+    for (int c = 0; c < 3; c++) b(i, c) = (i + c) % 5 - 2;
+  }
+  double det = matrix_a.Determinant();
+  for (auto triangle : {S21PackedMatrix::kLower, S21PackedMatrix::kUpper}) {
+    for (bool tiled : {false, true}) {
+      S21PackedMatrix packed(matrix_a, S21PackedMatrix::kSymmetric, triangle,
+                             tiled);
+      S21Matrix residual = matrix_a * packed.Solve(b) - b;
+      ASSERT_LT(residual.NormMax(), 1e-10);
+      ASSERT_NEAR(packed.Determinant() / det, 1.0, 1e-9);
+    }
+  }
+  S21PackedMatrix exchange(2, S21PackedMatrix::kSymmetric);  // 2x2 pivot
+  exchange(1, 0) = 1;
+  S21Matrix e(2, 1);
+  e(0, 0) = 3;
+  ASSERT_EQ(exchange.Determinant(), -1);
+  ASSERT_EQ(exchange.Solve(e)(1, 0), 3);
+  for (int i = 0; i < n; i++) matrix_a(i, 5) = matrix_a(5, i) = 0;
+  S21PackedMatrix singular(matrix_a, S21PackedMatrix::kSymmetric);
+  ASSERT_EQ(singular.Determinant(), 0);
+  ASSERT_THROW(singular.Solve(b), int);
+}
+
+TEST(PackedMatrix, Triangular) {
+  int n = 100;
+  S21Matrix lower(n, n);
+  S21Matrix b(n, 1);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= i; j++) lower(i, j) = i == j ? 2 : 0.01 * (i - j);
+    b(i, 0) = i % 3;
+  }
+  S21Matrix upper = lower.Transpose();
+  for (bool tiled : {false, true}) {
+    S21PackedMatrix l(lower, S21PackedMatrix::kTriangular,
+                      S21PackedMatrix::kLower, tiled);
+    S21PackedMatrix u(upper, S21PackedMatrix::kTriangular,
+                      S21PackedMatrix::kUpper, tiled);
+    ASSERT_TRUE(l.ToMatrix() == lower);
+    const S21PackedMatrix& view = u;
+    ASSERT_EQ(view(n - 1, 0), 0);
+    ASSERT_THROW(u(n - 1, 0) = 1, int);
+    ASSERT_TRUE(l * b == lower * b);
+    ASSERT_TRUE(lower * l.Solve(b) == b);
+    ASSERT_TRUE(upper * u.Solve(b) == b);
+    ASSERT_EQ(u.Determinant(), pow(2, n));
+  }
+  S21PackedMatrix singular(3, S21PackedMatrix::kTriangular);
+  ASSERT_EQ(singular.Determinant(), 0);
+  ASSERT_THROW(singular.Solve(S21Matrix(3, 1)), int);
+}
+
+TEST(Pow, True) {
+  S21Matrix matrix_a(3, 3);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) matrix_a(i, j) = (i == j) + 0.1 * (j - i);
+  S21Matrix expected = matrix_a;
+  for (int i = 1; i < 13; i++) expected *= matrix_a;
+  ASSERT_TRUE(matrix_a.Pow(13) == expected);
+  ASSERT_TRUE(matrix_a.Pow(1) == matrix_a);
+  S21Matrix inverse = matrix_a.InverseMatrix();
+  ASSERT_TRUE(matrix_a.Pow(-2) == inverse * inverse);
+  S21Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1;
+  ASSERT_TRUE(matrix_a.Pow(0) == identity);
+  ASSERT_THROW(S21Matrix(2, 3).Pow(2), int);
+
+  S21Matrix markov(2, 2);  // stationary distribution (2/3, 1/3)
+  markov(0, 0) = 0.9;
+  markov(0, 1) = 0.1;
+  markov(1, 0) = 0.2;
+  markov(1, 1) = 0.8;
+  S21Matrix limit = markov.Pow(1 << 20);
+  ASSERT_NEAR(limit(1, 0), 2.0 / 3, M_DIF);
+  ASSERT_NEAR(limit(0, 1), 1.0 / 3, M_DIF);
+}
+
+TEST(Polynomial, True) {
+  S21Matrix matrix_a(4, 4);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) matrix_a(i, j) = 0.25 * ((i + 2 * j) % 5) - 0.5;
+  vector<double> coefficients = {1, -2, 0, 0.5, 3, 0, -1, 0.25};
+  S21Matrix expected(4, 4), power(4, 4);
+  for (int i = 0; i < 4; i++) power(i, i) = 1;
+  for (double c : coefficients) {
+    expected += power * c;
+    power *= matrix_a;
+  }
+  ASSERT_TRUE(matrix_a.Polynomial(coefficients) == expected);
+  S21Matrix constant = matrix_a.Polynomial({2});
+  ASSERT_EQ(constant(1, 1), 2);
+  ASSERT_EQ(constant(1, 2), 0);
+  ASSERT_TRUE(matrix_a.Polynomial({0, 1}) == matrix_a);
+  ASSERT_THROW(matrix_a.Polynomial({}), int);
+}
+
+TEST(Kronecker, True) {
+  S21Matrix matrix_a(2, 2);
+  S21Matrix matrix_b(1, 3);
+  matrix_a(0, 0) = 1;
+  matrix_a(0, 1) = 2;
+  matrix_a(1, 0) = -1;
+  matrix_b(0, 0) = 1;
+  matrix_b(0, 1) = 0;
+  matrix_b(0, 2) = 3;
+  S21Matrix kron = Kronecker(matrix_a, matrix_b);
+  ASSERT_EQ(kron.rows(), 2);
+  ASSERT_EQ(kron.columns(), 6);
+  double expected[2][6] = {{1, 0, 3, 2, 0, 6}, {-1, 0, -3, 0, 0, 0}};
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 6; j++) ASSERT_EQ(kron(i, j), expected[i][j]);
+  ASSERT_THROW(Kronecker(matrix_a, S21Matrix()), int);
+}
+
+TEST(Kronecker, Operator) {
+  for (int shape = 0; shape < 2; shape++) {
+    int m = shape ? 2 : 7, n = 3, p = shape ? 8 : 2, q = 5;
+    S21Matrix matrix_a(m, n);
+    S21Matrix matrix_b(p, q);
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < n; j++) matrix_a(i, j) = sin(i + 2.0 * j);
+    for (int i = 0; i < p; i++)
+      for (int j = 0; j < q; j++) matrix_b(i, j) = cos(3.0 * i - j);
+    S21KroneckerOperator kron(matrix_a, matrix_b);
+    ASSERT_EQ(kron.rows(), m * p);
+    ASSERT_EQ(kron.columns(), n * q);
+    S21Matrix x(n * q, 2);
+    for (int i = 0; i < n * q; i++) {
+      x(i, 0) = i;
+      x(i, 1) = 1.0 / (i + 1);
+    }
+    ASSERT_TRUE(kron * x == kron.ToMatrix() * x);
+    ASSERT_THROW(kron * S21Matrix(n, 1), int);
+  }
+}
+
+TEST(Hadamard, True) {
+  S21Matrix matrix_a(2, 3);
+  S21Matrix matrix_b(2, 3);
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 3; j++) {
+      matrix_a(i, j) = i + j;
+      matrix_b(i, j) = i - j;
+    }
+  S21Matrix product = Hadamard(matrix_a, matrix_b);
+  ASSERT_EQ(product(1, 2), -3);
+  ASSERT_EQ(product(1, 0), 1);
+  ASSERT_THROW(Hadamard(matrix_a, S21Matrix(3, 2)), int);
+}
+
+TEST(MatrixIO, Read) {
+  S21Matrix matrix_a = ReadMatrix("1, -2.5,+3\r\n\n 4e2,5 ,0\n", ',');
+  ASSERT_EQ(matrix_a.rows(), 2);
+  ASSERT_EQ(matrix_a(0, 1), -2.5);
+  ASSERT_EQ(matrix_a(0, 2), 3);
+  ASSERT_EQ(matrix_a(1, 0), 400);
+  ASSERT_EQ(matrix_a(1, 2), 0);
+  S21Matrix matrix_b = ReadMatrix("1 2\t3\n4  5 6", ' ');
+  ASSERT_EQ(matrix_b(1, 1), 5);
+  ASSERT_EQ(ReadMatrix("\n\n").rows(), 0);
+  S21Matrix preallocated(2, 3);
+  ReadMatrix("1,2,3\n4,5,6\n", preallocated);
+  ASSERT_EQ(preallocated(1, 2), 6);
+  ASSERT_THROW(ReadMatrix("1,2\n3,4\n", preallocated), int);
+  ASSERT_THROW(ReadMatrix("1,2\n3\n"), int);
+  ASSERT_THROW(ReadMatrix("1,2\n3,4,5\n"), int);
+  ASSERT_THROW(ReadMatrix("1,x\n"), int);
+  ASSERT_THROW(ReadMatrix("1-2\n", ' '), int);
+  ASSERT_THROW(ReadMatrix("+-3\n"), int);
+  ASSERT_THROW(ReadMatrix("++3\n"), int);
+  ASSERT_THROW(ReadMatrix("1,+\n"), int);
+  ASSERT_THROW(ReadMatrixFile("/nonexistent/matrix.csv"), int);
+}
+
+TEST(MatrixIO, RoundTrip) {
+  S21Matrix matrix_a(3000, 40);
+  for (int i = 0; i < 3000; i++)
+    for (int j = 0; j < 40; j++) matrix_a(i, j) = sin(i * 40.0 + j) * 1e3;
+  matrix_a(7, 3) = -1e-300;
+  for (char delimiter : {',', ' ', ';'}) {
+    stringstream out;
+    WriteMatrix(out, matrix_a, delimiter);
+    S21Matrix matrix_b = ReadMatrix(out.str(), delimiter);
+    ASSERT_EQ(matrix_b.rows(), 3000);
+    for (int i = 0; i < 3000; i++)
+      for (int j = 0; j < 40; j++) ASSERT_EQ(matrix_b(i, j), matrix_a(i, j));
+  }
+  string path = testing::TempDir() + "s21_matrix_io.csv";
+  WriteMatrixFile(path, matrix_a);
+  ASSERT_TRUE(ReadMatrixFile(path) == matrix_a);
+  remove(path.c_str());
+}
+
+TEST(MatrixIO, ReadPipe) {
+  string path = testing::TempDir() + "s21_matrix_io.fifo";
+  remove(path.c_str());
+  ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+  thread writer([&path] {  // opening blocks until the reader has opened it
+    ofstream out(path);
+    out << "1,2\n3,4\n";
+  });
+  S21Matrix matrix_a = ReadMatrixFile(path);  // tellg() fails on a FIFO
+  writer.join();
+  remove(path.c_str());
+  ASSERT_EQ(matrix_a.rows(), 2);
+  ASSERT_EQ(matrix_a(1, 0), 3);
+}
+
+TEST(MatrixIO, Streaming) {
+  stringstream in("1 2 3\n\n4 5 6\n7 8\n");
+  S21MatrixReader reader(in, ' ');
+  S21Matrix row;
+  ASSERT_TRUE(reader.Next(row));
+  ASSERT_EQ(reader.columns(), 3);
+  ASSERT_EQ(row(0, 2), 3);
+  const double* buffer = row.data();
+  ASSERT_TRUE(reader.Next(row));
+  ASSERT_EQ(row.data(), buffer);
+  ASSERT_EQ(row(0, 0), 4);
+  ASSERT_THROW(reader.Next(row), int);
+  ASSERT_FALSE(reader.Next(row));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,47 @@
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+#include "../s21_matrix_oop.h"
+
+// Best of five wall-clock runs, in seconds
+static double best(const function<void()>& run) {
+  double result = HUGE_VAL;
+  for (int r = 0; r < 5; r++) {
+    auto start = chrono::steady_clock::now();
+    run();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    result = min(result, elapsed.count());
+  }
+  return result;
+}
+
+int main(int argc, char** argv) {
+  int n = argc > 1 ? atoi(argv[1]) : 800;
+  if (n <= 0) return 1;
+  // SolveMixed takes the float LU path up to n / 32 right-hand sides and
+  // a double LU beyond, so one column more compares the two paths
+  int k = max(1, n / 32);
+  S21Matrix a(n, n), b(n, n), mixed_rhs(n, k), double_rhs(n, k + 1);
+  for (int i = 0; i < n; i++) {
+    for (int c = 0; c <= k; c++) double_rhs(i, c) = (i + c) % 7 - 3;
+    for (int c = 0; c < k; c++) mixed_rhs(i, c) = (i + c) % 7 - 3;
+    for (int j = 0; j < n; j++) {
+      a(i, j) = sin(i * 0.37 + j * 1.13) + (i == j ? 4.0 : 0.0);
+      b(i, j) = cos(i * 0.71 - j * 0.29);
+    }
+  }
+  double mul = best([&] { S21Matrix c = a * b; });
+  double mul_mixed = best([&] {
+    S21Matrix c(a);
+    c.MulMatrixMixed(b);
+  });
+  double solve = best([&] { a.SolveMixed(double_rhs); });
+  double solve_mixed = best([&] { a.SolveMixed(mixed_rhs); });
+  cout << "n=" << n << " MulMatrix " << mul << "s MulMatrixMixed "
+       << mul_mixed << "s" << endl;
+  cout << "n=" << n << " double solve (" << k + 1 << " rhs) " << solve
+       << "s refined float solve (" << k << " rhs) " << solve_mixed << "s"
+       << endl;
+  return 0;
+}
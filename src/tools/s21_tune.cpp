@@ -0,0 +1,18 @@
+#include <cstdlib>
+
+#include "../s21_matrix_oop.h"
+#include "../s21_tuning.h"
+
+int main(int argc, char** argv) {
+  int size = argc > 1 ? atoi(argv[1]) : 256;
+  string path = argc > 2 ? argv[2] : S21Autotuner::ProfilePath();
+  S21Tuning tuning = S21Autotuner::Tune(size);
+  if (!S21Autotuner::Save(path)) {
+    cerr << "cannot write " << path << endl;
+    return 1;
+  }
+  cout << path << ": block_k=" << tuning.block_k
+       << " block_n=" << tuning.block_n << " row_chunk=" << tuning.row_chunk
+       << " parallel_threshold=" << tuning.parallel_threshold << endl;
+  return 0;
+}